@@ -0,0 +1,346 @@
+#include "AabbOverlap.hpp"
+#include "Types.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define OVERLAP_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define OVERLAP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define OVERLAP_TARGET_AVX2
+#endif
+
+using PairRange = const std::pair<uint32_t, uint32_t> *;
+
+// Every word kernel tests the entries [begin, end) of a single word and returns its bits, the
+// range kernels below only split ranges into words
+using PairsWordKernel = uint64_t (*)(const AabbBatch &boxes, PairRange pairs, size_t begin,
+                                     size_t end);
+using BoxWordKernel = uint64_t (*)(const AabbBatch &boxes, SDL_Rect box, size_t begin,
+                                   size_t end);
+
+// Same test as SDL_HasIntersection, empty boxes are inside out and fail it
+static bool BoxesOverlap(const AabbBatch &boxes, uint32_t box_1, uint32_t box_2) {
+    return boxes.min_x[box_1] < boxes.max_x[box_2] && boxes.min_x[box_2] < boxes.max_x[box_1] &&
+           boxes.min_y[box_1] < boxes.max_y[box_2] && boxes.min_y[box_2] < boxes.max_y[box_1];
+}
+
+static void GetExtents(SDL_Rect box, int32_t &min_x, int32_t &min_y, int32_t &max_x,
+                       int32_t &max_y) {
+    if (box.w <= 0 || box.h <= 0) {
+        min_x = min_y = std::numeric_limits<int32_t>::max();
+        max_x = max_y = std::numeric_limits<int32_t>::min();
+        return;
+    }
+
+    min_x = box.x;
+    min_y = box.y;
+    max_x = box.x + box.w;
+    max_y = box.y + box.h;
+}
+
+static uint64_t TestPairsWordScalar(const AabbBatch &boxes, PairRange pairs, size_t begin,
+                                    size_t end) {
+    uint64_t word = 0;
+    for (size_t i = begin; i < end; i++) {
+        if (BoxesOverlap(boxes, pairs[i].first, pairs[i].second)) {
+            word |= uint64_t(1) << (i - begin);
+        }
+    }
+    return word;
+}
+
+static uint64_t TestBoxWordScalar(const AabbBatch &boxes, SDL_Rect box, size_t begin,
+                                  size_t end) {
+    int32_t min_x, min_y, max_x, max_y;
+    GetExtents(box, min_x, min_y, max_x, max_y);
+
+    uint64_t word = 0;
+    for (size_t i = begin; i < end; i++) {
+        if (min_x < boxes.max_x[i] && boxes.min_x[i] < max_x && min_y < boxes.max_y[i] &&
+            boxes.min_y[i] < max_y) {
+            word |= uint64_t(1) << (i - begin);
+        }
+    }
+    return word;
+}
+
+#ifdef OVERLAP_X86
+// SSE has no gather, so the extents of four pairs are loaded lane by lane
+static __m128i LoadPairExtents(const int32_t *field, PairRange pairs, bool first) {
+    if (first) {
+        return _mm_set_epi32(field[pairs[3].first], field[pairs[2].first], field[pairs[1].first],
+                             field[pairs[0].first]);
+    }
+    return _mm_set_epi32(field[pairs[3].second], field[pairs[2].second], field[pairs[1].second],
+                         field[pairs[0].second]);
+}
+
+static uint64_t TestPairsWordSSE(const AabbBatch &boxes, PairRange pairs, size_t begin,
+                                 size_t end) {
+    const int32_t *min_x = boxes.min_x.data();
+    const int32_t *min_y = boxes.min_y.data();
+    const int32_t *max_x = boxes.max_x.data();
+    const int32_t *max_y = boxes.max_y.data();
+
+    uint64_t word = 0;
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        PairRange group = pairs + i;
+        __m128i overlap = _mm_and_si128(
+            _mm_and_si128(_mm_cmpgt_epi32(LoadPairExtents(max_x, group, false),
+                                          LoadPairExtents(min_x, group, true)),
+                          _mm_cmpgt_epi32(LoadPairExtents(max_x, group, true),
+                                          LoadPairExtents(min_x, group, false))),
+            _mm_and_si128(_mm_cmpgt_epi32(LoadPairExtents(max_y, group, false),
+                                          LoadPairExtents(min_y, group, true)),
+                          _mm_cmpgt_epi32(LoadPairExtents(max_y, group, true),
+                                          LoadPairExtents(min_y, group, false))));
+        word |= uint64_t(_mm_movemask_ps(_mm_castsi128_ps(overlap))) << (i - begin);
+    }
+
+    if (i < end) {
+        word |= TestPairsWordScalar(boxes, pairs, i, end) << (i - begin);
+    }
+    return word;
+}
+
+static uint64_t TestBoxWordSSE(const AabbBatch &boxes, SDL_Rect box, size_t begin, size_t end) {
+    int32_t min_x, min_y, max_x, max_y;
+    GetExtents(box, min_x, min_y, max_x, max_y);
+    const __m128i box_min_x = _mm_set1_epi32(min_x);
+    const __m128i box_min_y = _mm_set1_epi32(min_y);
+    const __m128i box_max_x = _mm_set1_epi32(max_x);
+    const __m128i box_max_y = _mm_set1_epi32(max_y);
+
+    uint64_t word = 0;
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128i lane_min_x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&boxes.min_x[i]));
+        __m128i lane_min_y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&boxes.min_y[i]));
+        __m128i lane_max_x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&boxes.max_x[i]));
+        __m128i lane_max_y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&boxes.max_y[i]));
+
+        __m128i overlap =
+            _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(lane_max_x, box_min_x),
+                                        _mm_cmpgt_epi32(box_max_x, lane_min_x)),
+                          _mm_and_si128(_mm_cmpgt_epi32(lane_max_y, box_min_y),
+                                        _mm_cmpgt_epi32(box_max_y, lane_min_y)));
+        word |= uint64_t(_mm_movemask_ps(_mm_castsi128_ps(overlap))) << (i - begin);
+    }
+
+    if (i < end) {
+        word |= TestBoxWordScalar(boxes, box, i, end) << (i - begin);
+    }
+    return word;
+}
+
+// Four pairs are loaded as eight indices, so every even lane holds the first box of a pair and the
+// odd lane next to it the second one. Swapping neighbouring lanes lines each box up with the other
+// box of its pair, and a pair overlaps when the tests of both of its lanes pass.
+OVERLAP_TARGET_AVX2
+static uint64_t TestPairsWordAVX2(const AabbBatch &boxes, PairRange pairs, size_t begin,
+                                  size_t end) {
+    const int32_t *min_x = boxes.min_x.data();
+    const int32_t *min_y = boxes.min_y.data();
+    const int32_t *max_x = boxes.max_x.data();
+    const int32_t *max_y = boxes.max_y.data();
+    const int SWAP_NEIGHBOURS = _MM_SHUFFLE(2, 3, 0, 1);
+
+    uint64_t word = 0;
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pairs + i));
+        __m256i lane_min_x = _mm256_i32gather_epi32(min_x, indices, 4);
+        __m256i lane_min_y = _mm256_i32gather_epi32(min_y, indices, 4);
+        __m256i other_max_x =
+            _mm256_shuffle_epi32(_mm256_i32gather_epi32(max_x, indices, 4), SWAP_NEIGHBOURS);
+        __m256i other_max_y =
+            _mm256_shuffle_epi32(_mm256_i32gather_epi32(max_y, indices, 4), SWAP_NEIGHBOURS);
+
+        __m256i overlap = _mm256_and_si256(_mm256_cmpgt_epi32(other_max_x, lane_min_x),
+                                           _mm256_cmpgt_epi32(other_max_y, lane_min_y));
+        overlap = _mm256_and_si256(overlap, _mm256_shuffle_epi32(overlap, SWAP_NEIGHBOURS));
+
+        // Both lanes of a pair agree now, so the even lanes alone hold the four results
+        int lanes = _mm256_movemask_ps(_mm256_castsi256_ps(overlap));
+        uint64_t bits =
+            (lanes & 0x1) | ((lanes >> 1) & 0x2) | ((lanes >> 2) & 0x4) | ((lanes >> 3) & 0x8);
+        word |= bits << (i - begin);
+    }
+
+    if (i < end) {
+        word |= TestPairsWordScalar(boxes, pairs, i, end) << (i - begin);
+    }
+    return word;
+}
+
+OVERLAP_TARGET_AVX2
+static uint64_t TestBoxWordAVX2(const AabbBatch &boxes, SDL_Rect box, size_t begin, size_t end) {
+    int32_t min_x, min_y, max_x, max_y;
+    GetExtents(box, min_x, min_y, max_x, max_y);
+    const __m256i box_min_x = _mm256_set1_epi32(min_x);
+    const __m256i box_min_y = _mm256_set1_epi32(min_y);
+    const __m256i box_max_x = _mm256_set1_epi32(max_x);
+    const __m256i box_max_y = _mm256_set1_epi32(max_y);
+
+    uint64_t word = 0;
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const int32_t *lanes = &boxes.min_x[i];
+        __m256i lane_min_x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes));
+        lanes = &boxes.min_y[i];
+        __m256i lane_min_y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes));
+        lanes = &boxes.max_x[i];
+        __m256i lane_max_x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes));
+        lanes = &boxes.max_y[i];
+        __m256i lane_max_y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes));
+
+        __m256i overlap =
+            _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi32(lane_max_x, box_min_x),
+                                              _mm256_cmpgt_epi32(box_max_x, lane_min_x)),
+                             _mm256_and_si256(_mm256_cmpgt_epi32(lane_max_y, box_min_y),
+                                              _mm256_cmpgt_epi32(box_max_y, lane_min_y)));
+        word |= uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(overlap))) << (i - begin);
+    }
+
+    if (i < end) {
+        word |= TestBoxWordSSE(boxes, box, i, end) << (i - begin);
+    }
+    return word;
+}
+
+static bool SupportsAVX2() {
+#if defined(_MSC_VER)
+    int registers[4];
+    __cpuid(registers, 1);
+    bool os_saves_ymm = (registers[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(registers, 7, 0);
+    return os_saves_ymm && (registers[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+template <PairsWordKernel word_kernel>
+static void TestPairsByWord(const AabbBatch &boxes, PairRange pairs, size_t begin, size_t end,
+                            uint64_t *hits) {
+    for (size_t i = begin; i < end; i += HIT_MASK_WORD_BITS) {
+        size_t word_end = std::min(i + HIT_MASK_WORD_BITS, end);
+        hits[i / HIT_MASK_WORD_BITS] = word_kernel(boxes, pairs, i, word_end);
+    }
+}
+
+template <BoxWordKernel word_kernel>
+static void TestBoxByWord(const AabbBatch &boxes, SDL_Rect box, size_t begin, size_t end,
+                          uint64_t *hits) {
+    for (size_t i = begin; i < end; i += HIT_MASK_WORD_BITS) {
+        size_t word_end = std::min(i + HIT_MASK_WORD_BITS, end);
+        hits[i / HIT_MASK_WORD_BITS] = word_kernel(boxes, box, i, word_end);
+    }
+}
+
+AabbOverlap::AabbOverlap() {
+    this->pairs_kernel = TestPairsByWord<TestPairsWordScalar>;
+    this->box_kernel = TestBoxByWord<TestBoxWordScalar>;
+    this->kernel_name = "scalar";
+
+#ifdef OVERLAP_X86
+    this->pairs_kernel = TestPairsByWord<TestPairsWordSSE>;
+    this->box_kernel = TestBoxByWord<TestBoxWordSSE>;
+    this->kernel_name = "SSE";
+    if (SupportsAVX2()) {
+        this->pairs_kernel = TestPairsByWord<TestPairsWordAVX2>;
+        this->box_kernel = TestBoxByWord<TestBoxWordAVX2>;
+        this->kernel_name = "AVX2";
+    }
+#endif
+}
+
+const char *AabbOverlap::GetKernelName() { return this->kernel_name; }
+
+void AabbOverlap::TestPairs(const AabbBatch &boxes, const std::pair<uint32_t, uint32_t> *pairs,
+                            size_t begin, size_t end, uint64_t *hits) {
+    this->pairs_kernel(boxes, pairs, begin, end, hits);
+}
+
+void AabbOverlap::TestBox(const AabbBatch &boxes, SDL_Rect box, size_t begin, size_t end,
+                          uint64_t *hits) {
+    this->box_kernel(boxes, box, begin, end, hits);
+}
+
+void ClearAabbBatch(AabbBatch &batch) {
+    batch.min_x.clear();
+    batch.min_y.clear();
+    batch.max_x.clear();
+    batch.max_y.clear();
+}
+
+void AddToAabbBatch(AabbBatch &batch, SDL_Rect box) {
+    int32_t min_x, min_y, max_x, max_y;
+    GetExtents(box, min_x, min_y, max_x, max_y);
+    batch.min_x.push_back(min_x);
+    batch.min_y.push_back(min_y);
+    batch.max_x.push_back(max_x);
+    batch.max_y.push_back(max_y);
+}
+
+size_t GetHitMaskWords(size_t count) {
+    return (count + HIT_MASK_WORD_BITS - 1) / HIT_MASK_WORD_BITS;
+}
+
+// Slab test against the half open box, one axis at a time. A segment that only grazes an edge or
+// ends on one does not enter the box.
+bool GetRayHit(Position start, Position end, const SDL_Rect &box, float &fraction,
+               Position &normal) {
+    if (box.w <= 0 || box.h <= 0) {
+        return false;
+    }
+
+    const float starts[2] = {start.x, start.y};
+    const float deltas[2] = {end.x - start.x, end.y - start.y};
+    const float mins[2] = {float(box.x), float(box.y)};
+    const float maxs[2] = {float(box.x + box.w), float(box.y + box.h)};
+
+    float enter_fraction = 0.0f;
+    float exit_fraction = 1.0f;
+    Position enter_normal = Position{0, 0};
+    for (int axis = 0; axis < 2; axis++) {
+        if (deltas[axis] == 0.0f) {
+            if (starts[axis] < mins[axis] || starts[axis] >= maxs[axis]) {
+                return false;
+            }
+            continue;
+        }
+
+        // The normal of the side entered through points back along the segment
+        float axis_enter = (mins[axis] - starts[axis]) / deltas[axis];
+        float axis_exit = (maxs[axis] - starts[axis]) / deltas[axis];
+        float side = -1.0f;
+        if (axis_enter > axis_exit) {
+            std::swap(axis_enter, axis_exit);
+            side = 1.0f;
+        }
+        if (axis_enter > enter_fraction) {
+            enter_fraction = axis_enter;
+            enter_normal = axis == 0 ? Position{side, 0} : Position{0, side};
+        }
+        exit_fraction = std::min(exit_fraction, axis_exit);
+        if (enter_fraction >= exit_fraction) {
+            return false;
+        }
+    }
+
+    fraction = enter_fraction;
+    normal = enter_normal;
+    return true;
+}
\ No newline at end of file
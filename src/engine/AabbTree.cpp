@@ -0,0 +1,412 @@
+#include "AabbTree.hpp"
+#include "AabbOverlap.hpp"
+#include "Types.hpp"
+#include <algorithm>
+#include <numeric>
+
+static constexpr int NULL_NODE = -1;
+
+// Queries only read a tree, and keep their traversal stacks per thread, so a tree that is not being
+// changed can be queried from several threads at once
+static thread_local std::vector<uint32_t> query_stack;
+static thread_local std::vector<int> proxy_stack;
+
+static SDL_Rect GetUnion(const SDL_Rect &box_1, const SDL_Rect &box_2) {
+    int min_x = std::min(box_1.x, box_2.x);
+    int min_y = std::min(box_1.y, box_2.y);
+    int max_x = std::max(box_1.x + box_1.w, box_2.x + box_2.w);
+    int max_y = std::max(box_1.y + box_1.h, box_2.y + box_2.h);
+    return SDL_Rect{min_x, min_y, max_x - min_x, max_y - min_y};
+}
+
+static int64_t GetPerimeter(const SDL_Rect &box) { return 2 * (int64_t(box.w) + box.h); }
+
+static bool Contains(const SDL_Rect &outer, const SDL_Rect &inner) {
+    return outer.x <= inner.x && outer.y <= inner.y && inner.x + inner.w <= outer.x + outer.w &&
+           inner.y + inner.h <= outer.y + outer.h;
+}
+
+// Touching boxes count as overlapping here, so the trees never drop a pair the narrowphase wants
+static bool Touches(const SDL_Rect &box_1, const SDL_Rect &box_2) {
+    return box_1.x <= box_2.x + box_2.w && box_2.x <= box_1.x + box_1.w &&
+           box_1.y <= box_2.y + box_2.h && box_2.y <= box_1.y + box_1.h;
+}
+
+static bool RayEnters(Position start, Position end, const SDL_Rect &box) {
+    float fraction;
+    Position normal;
+    return GetRayHit(start, end, box, fraction, normal);
+}
+
+void StaticAabbTree::Build(const std::vector<SDL_Rect> &boxes) {
+    this->nodes.clear();
+    this->boxes = boxes;
+    this->box_order.resize(boxes.size());
+    std::iota(this->box_order.begin(), this->box_order.end(), 0);
+
+    if (!boxes.empty()) {
+        this->BuildNode(0, uint32_t(boxes.size()));
+    }
+}
+
+uint32_t StaticAabbTree::BuildNode(uint32_t begin, uint32_t end) {
+    uint32_t node = uint32_t(this->nodes.size());
+    this->nodes.push_back(Node{});
+
+    SDL_Rect box = this->boxes[this->box_order[begin]];
+    for (uint32_t i = begin + 1; i < end; i++) {
+        box = GetUnion(box, this->boxes[this->box_order[i]]);
+    }
+
+    if (end - begin <= STATIC_TREE_LEAF_SIZE) {
+        this->nodes[node] = Node{box, begin, end - begin, 0};
+        return node;
+    }
+
+    // Centres are compared doubled, which keeps them in integers
+    bool split_x = box.w >= box.h;
+    uint32_t middle = begin + (end - begin) / 2;
+    const std::vector<SDL_Rect> &boxes = this->boxes;
+    std::nth_element(this->box_order.begin() + begin, this->box_order.begin() + middle,
+                     this->box_order.begin() + end,
+                     [&boxes, split_x](uint32_t index_1, uint32_t index_2) {
+                         const SDL_Rect &box_1 = boxes[index_1];
+                         const SDL_Rect &box_2 = boxes[index_2];
+                         if (split_x) {
+                             return 2 * box_1.x + box_1.w < 2 * box_2.x + box_2.w;
+                         }
+                         return 2 * box_1.y + box_1.h < 2 * box_2.y + box_2.h;
+                     });
+
+    this->BuildNode(begin, middle);
+    uint32_t right = this->BuildNode(middle, end);
+    this->nodes[node] = Node{box, begin, 0, right};
+    return node;
+}
+
+// Appends the index, in the order given to Build, of every box touching the query box
+void StaticAabbTree::Query(SDL_Rect box, std::vector<uint32_t> &results) {
+    if (this->nodes.empty()) {
+        return;
+    }
+
+    query_stack.clear();
+    query_stack.push_back(0);
+    while (!query_stack.empty()) {
+        uint32_t index = query_stack.back();
+        query_stack.pop_back();
+
+        const Node &node = this->nodes[index];
+        if (!Touches(node.box, box)) {
+            continue;
+        }
+
+        if (node.count == 0) {
+            query_stack.push_back(node.right);
+            query_stack.push_back(index + 1);
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+            if (Touches(this->boxes[this->box_order[i]], box)) {
+                results.push_back(this->box_order[i]);
+            }
+        }
+    }
+}
+
+// Appends the index of every box the segment from start to end enters. Every box inside a node
+// is inside the node's box, so nodes the segment misses are skipped whole.
+void StaticAabbTree::RayCast(Position start, Position end, std::vector<uint32_t> &results) {
+    if (this->nodes.empty()) {
+        return;
+    }
+
+    query_stack.clear();
+    query_stack.push_back(0);
+    while (!query_stack.empty()) {
+        uint32_t index = query_stack.back();
+        query_stack.pop_back();
+
+        const Node &node = this->nodes[index];
+        if (!RayEnters(start, end, node.box)) {
+            continue;
+        }
+
+        if (node.count == 0) {
+            query_stack.push_back(node.right);
+            query_stack.push_back(index + 1);
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+            if (RayEnters(start, end, this->boxes[this->box_order[i]])) {
+                results.push_back(this->box_order[i]);
+            }
+        }
+    }
+}
+
+DynamicAabbTree::DynamicAabbTree() {
+    this->root = NULL_NODE;
+    this->free_node = NULL_NODE;
+}
+
+int DynamicAabbTree::AllocateNode() {
+    if (this->free_node == NULL_NODE) {
+        this->nodes.push_back(Node{});
+        return int(this->nodes.size()) - 1;
+    }
+
+    int node = this->free_node;
+    this->free_node = this->nodes[node].parent;
+    return node;
+}
+
+void DynamicAabbTree::FreeNode(int node) {
+    this->nodes[node].parent = this->free_node;
+    this->nodes[node].height = -1;
+    this->free_node = node;
+}
+
+bool DynamicAabbTree::IsLeaf(int node) { return this->nodes[node].child_1 == NULL_NODE; }
+
+int DynamicAabbTree::CreateProxy(SDL_Rect box, uint32_t user) {
+    int proxy = this->AllocateNode();
+    SDL_Rect fat_box = {box.x - AABB_TREE_MARGIN, box.y - AABB_TREE_MARGIN,
+                        box.w + 2 * AABB_TREE_MARGIN, box.h + 2 * AABB_TREE_MARGIN};
+    this->nodes[proxy] = Node{fat_box, NULL_NODE, NULL_NODE, NULL_NODE, 0, user};
+    this->InsertLeaf(proxy);
+    return proxy;
+}
+
+void DynamicAabbTree::DestroyProxy(int proxy) {
+    this->RemoveLeaf(proxy);
+    this->FreeNode(proxy);
+}
+
+// Returns whether the proxy had to be reinserted, which only happens once the box leaves the fat
+// box it was inserted with
+bool DynamicAabbTree::MoveProxy(int proxy, SDL_Rect box) {
+    if (Contains(this->nodes[proxy].box, box)) {
+        return false;
+    }
+
+    this->RemoveLeaf(proxy);
+    this->nodes[proxy].box = {box.x - AABB_TREE_MARGIN, box.y - AABB_TREE_MARGIN,
+                              box.w + 2 * AABB_TREE_MARGIN, box.h + 2 * AABB_TREE_MARGIN};
+    this->InsertLeaf(proxy);
+    return true;
+}
+
+void DynamicAabbTree::SetUser(int proxy, uint32_t user) { this->nodes[proxy].user = user; }
+
+// Walks down to the sibling that grows the tree's total perimeter the least, pairs the leaf with it
+// under a new parent and refits the ancestors on the way back up
+void DynamicAabbTree::InsertLeaf(int leaf) {
+    if (this->root == NULL_NODE) {
+        this->root = leaf;
+        this->nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    SDL_Rect leaf_box = this->nodes[leaf].box;
+    int index = this->root;
+    while (!this->IsLeaf(index)) {
+        const Node &node = this->nodes[index];
+        int64_t combined_perimeter = GetPerimeter(GetUnion(node.box, leaf_box));
+
+        // Cost of pairing the leaf with this node, and the least it costs to go further down
+        int64_t cost = 2 * combined_perimeter;
+        int64_t inheritance = 2 * (combined_perimeter - GetPerimeter(node.box));
+
+        int64_t child_costs[2];
+        int children[2] = {node.child_1, node.child_2};
+        for (int i = 0; i < 2; i++) {
+            const Node &child = this->nodes[children[i]];
+            int64_t perimeter = GetPerimeter(GetUnion(child.box, leaf_box));
+            if (!this->IsLeaf(children[i])) {
+                perimeter -= GetPerimeter(child.box);
+            }
+            child_costs[i] = perimeter + inheritance;
+        }
+
+        if (cost < child_costs[0] && cost < child_costs[1]) {
+            break;
+        }
+        index = child_costs[0] < child_costs[1] ? children[0] : children[1];
+    }
+
+    int sibling = index;
+    int old_parent = this->nodes[sibling].parent;
+    int new_parent = this->AllocateNode();
+    this->nodes[new_parent] = Node{GetUnion(leaf_box, this->nodes[sibling].box),
+                                   old_parent,
+                                   sibling,
+                                   leaf,
+                                   this->nodes[sibling].height + 1,
+                                   0};
+    this->nodes[sibling].parent = new_parent;
+    this->nodes[leaf].parent = new_parent;
+
+    if (old_parent == NULL_NODE) {
+        this->root = new_parent;
+    } else if (this->nodes[old_parent].child_1 == sibling) {
+        this->nodes[old_parent].child_1 = new_parent;
+    } else {
+        this->nodes[old_parent].child_2 = new_parent;
+    }
+
+    this->Refit(this->nodes[leaf].parent);
+}
+
+void DynamicAabbTree::RemoveLeaf(int leaf) {
+    if (leaf == this->root) {
+        this->root = NULL_NODE;
+        return;
+    }
+
+    int parent = this->nodes[leaf].parent;
+    int grandparent = this->nodes[parent].parent;
+    int sibling = this->nodes[parent].child_1 == leaf ? this->nodes[parent].child_2
+                                                      : this->nodes[parent].child_1;
+
+    this->nodes[sibling].parent = grandparent;
+    this->FreeNode(parent);
+    if (grandparent == NULL_NODE) {
+        this->root = sibling;
+        return;
+    }
+
+    if (this->nodes[grandparent].child_1 == parent) {
+        this->nodes[grandparent].child_1 = sibling;
+    } else {
+        this->nodes[grandparent].child_2 = sibling;
+    }
+    this->Refit(grandparent);
+}
+
+// Rebalances and recomputes the boxes and heights of a node and all of its ancestors
+void DynamicAabbTree::Refit(int node) {
+    int index = node;
+    while (index != NULL_NODE) {
+        index = this->Balance(index);
+
+        Node &current = this->nodes[index];
+        const Node &child_1 = this->nodes[current.child_1];
+        const Node &child_2 = this->nodes[current.child_2];
+        current.height = 1 + std::max(child_1.height, child_2.height);
+        current.box = GetUnion(child_1.box, child_2.box);
+
+        index = current.parent;
+    }
+}
+
+// Rotates the taller child up when the heights of the two children differ by more than one, and
+// returns the node that now sits where the given node was
+int DynamicAabbTree::Balance(int node_a) {
+    Node &a = this->nodes[node_a];
+    if (this->IsLeaf(node_a) || a.height < 2) {
+        return node_a;
+    }
+
+    int node_b = a.child_1;
+    int node_c = a.child_2;
+    Node &b = this->nodes[node_b];
+    Node &c = this->nodes[node_c];
+    int balance = c.height - b.height;
+    if (balance >= -1 && balance <= 1) {
+        return node_a;
+    }
+
+    // The taller child takes the node's place, the node takes the taller child's place, and the
+    // taller grandchild stays under the child that moved up
+    bool rotate_c = balance > 1;
+    int node_up = rotate_c ? node_c : node_b;
+    Node &up = rotate_c ? c : b;
+    Node &other = rotate_c ? b : c;
+    int node_f = up.child_1;
+    int node_g = up.child_2;
+    Node &f = this->nodes[node_f];
+    Node &g = this->nodes[node_g];
+
+    up.child_1 = node_a;
+    up.parent = a.parent;
+    a.parent = node_up;
+    if (up.parent == NULL_NODE) {
+        this->root = node_up;
+    } else if (this->nodes[up.parent].child_1 == node_a) {
+        this->nodes[up.parent].child_1 = node_up;
+    } else {
+        this->nodes[up.parent].child_2 = node_up;
+    }
+
+    int node_kept = f.height > g.height ? node_f : node_g;
+    int node_moved = f.height > g.height ? node_g : node_f;
+    Node &kept = this->nodes[node_kept];
+    Node &moved = this->nodes[node_moved];
+
+    up.child_2 = node_kept;
+    if (rotate_c) {
+        a.child_2 = node_moved;
+    } else {
+        a.child_1 = node_moved;
+    }
+    moved.parent = node_a;
+
+    a.box = GetUnion(other.box, moved.box);
+    a.height = 1 + std::max(other.height, moved.height);
+    up.box = GetUnion(a.box, kept.box);
+    up.height = 1 + std::max(a.height, kept.height);
+    return node_up;
+}
+
+// Appends the user value of every proxy whose fat box touches the query box
+void DynamicAabbTree::Query(SDL_Rect box, std::vector<uint32_t> &results) {
+    if (this->root == NULL_NODE) {
+        return;
+    }
+
+    proxy_stack.clear();
+    proxy_stack.push_back(this->root);
+    while (!proxy_stack.empty()) {
+        int index = proxy_stack.back();
+        proxy_stack.pop_back();
+
+        const Node &node = this->nodes[index];
+        if (!Touches(node.box, box)) {
+            continue;
+        }
+
+        if (this->IsLeaf(index)) {
+            results.push_back(node.user);
+        } else {
+            proxy_stack.push_back(node.child_1);
+            proxy_stack.push_back(node.child_2);
+        }
+    }
+}
+
+// Appends the user value of every proxy whose fat box the segment from start to end enters
+void DynamicAabbTree::RayCast(Position start, Position end, std::vector<uint32_t> &results) {
+    if (this->root == NULL_NODE) {
+        return;
+    }
+
+    proxy_stack.clear();
+    proxy_stack.push_back(this->root);
+    while (!proxy_stack.empty()) {
+        int index = proxy_stack.back();
+        proxy_stack.pop_back();
+
+        const Node &node = this->nodes[index];
+        if (!RayEnters(start, end, node.box)) {
+            continue;
+        }
+
+        if (this->IsLeaf(index)) {
+            results.push_back(node.user);
+        } else {
+            proxy_stack.push_back(node.child_1);
+            proxy_stack.push_back(node.child_2);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "Broadphase.hpp"
+#include "Entity.hpp"
+#include "Types.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+#include <cmath>
+
+#include "Profile.hpp"
+PROFILED;
+
+Broadphase::Broadphase() {
+    this->mode = BroadphaseMode::Tree;
+    this->step = 0;
+}
+
+BroadphaseMode Broadphase::GetMode() { return this->mode; }
+void Broadphase::SetMode(BroadphaseMode mode) { this->mode = mode; }
+void Broadphase::SetCellSize(int cell_size) { this->grid.SetCellSize(cell_size); }
+
+// Unlike query_results, which FindPairs uses, query scratch is kept per thread, so queries can be
+// made from several threads between collision tests
+static thread_local std::vector<uint32_t> query_leaves;
+
+static bool IsStatic(const Collider &collider) {
+    return collider.entity->GetCategory() == EntityCategory::Stationary;
+}
+
+static bool SameBox(const SDL_Rect &box_1, const SDL_Rect &box_2) {
+    return box_1.x == box_2.x && box_1.y == box_2.y && box_1.w == box_2.w && box_1.h == box_2.h;
+}
+
+// Emits every candidate pair once, lower collider index first, in ascending order, which is the
+// order a full pairwise loop would have tested them in
+void Broadphase::FindPairs(const std::vector<Collider> &colliders, size_t awake_count,
+                           std::vector<std::pair<uint32_t, uint32_t>> &pairs) {
+    ZoneScoped;
+
+    pairs.clear();
+    this->boxes.clear();
+    for (const Collider &collider : colliders) {
+        SDL_Rect box = collider.rect;
+        if (collider.swept) {
+            SDL_UnionRect(&collider.rect, &collider.start_rect, &box);
+        }
+        this->boxes.push_back(box);
+    }
+
+    if (this->mode == BroadphaseMode::Grid) {
+        this->FindGridPairs(colliders, awake_count, pairs);
+    } else {
+        this->FindTreePairs(colliders, awake_count, pairs);
+    }
+}
+
+// Sleeping colliders still go into the grid so awake ones can find them
+void Broadphase::FindGridPairs(const std::vector<Collider> &colliders, size_t awake_count,
+                               std::vector<std::pair<uint32_t, uint32_t>> &pairs) {
+    this->grid.Clear();
+    for (size_t i = 0; i < colliders.size(); i++) {
+        this->grid.Insert(this->boxes[i], colliders[i].filter);
+    }
+    this->grid.GetCandidatePairs(pairs);
+    pairs.erase(std::remove_if(pairs.begin(), pairs.end(),
+                               [awake_count](const std::pair<uint32_t, uint32_t> &pair) {
+                                   return pair.first >= awake_count;
+                               }),
+                pairs.end());
+}
+
+// Sleeping colliders keep their proxies so awake ones can find them, but never query themselves
+void Broadphase::FindTreePairs(const std::vector<Collider> &colliders, size_t awake_count,
+                               std::vector<std::pair<uint32_t, uint32_t>> &pairs) {
+    this->UpdateStaticTree(colliders);
+    this->UpdateDynamicTree(colliders);
+
+    std::vector<uint32_t> &results = this->query_results;
+    for (uint32_t collider : this->dynamic_colliders) {
+        if (collider >= awake_count) {
+            break;
+        }
+
+        const SDL_Rect &box = this->boxes[collider];
+        const CollisionFilter &filter = colliders[collider].filter;
+
+        // A pair of awake moving colliders is found from both sides, so it is kept from the lower
+        // index only. Sleeping colliders come after the awake ones and are always kept.
+        results.clear();
+        this->dynamic_tree.Query(box, results);
+        for (uint32_t other : results) {
+            if (other > collider && CanCollide(filter, colliders[other].filter) &&
+                SDL_HasIntersection(&box, &this->boxes[other])) {
+                pairs.emplace_back(collider, other);
+            }
+        }
+
+        results.clear();
+        this->static_tree.Query(box, results);
+        for (uint32_t leaf : results) {
+            uint32_t other = this->static_colliders[leaf];
+            if (CanCollide(filter, colliders[other].filter) &&
+                SDL_HasIntersection(&box, &this->boxes[other])) {
+                pairs.emplace_back(std::min(collider, other), std::max(collider, other));
+            }
+        }
+    }
+
+    // Stationary colliders that were moved are awake too, and are the only ones that can find the
+    // sleeping moving colliders and the other stationary colliders they were moved into
+    for (uint32_t collider : this->static_colliders) {
+        if (collider >= awake_count) {
+            continue;
+        }
+
+        const SDL_Rect &box = this->boxes[collider];
+        const CollisionFilter &filter = colliders[collider].filter;
+
+        results.clear();
+        this->dynamic_tree.Query(box, results);
+        for (uint32_t other : results) {
+            if (other >= awake_count && CanCollide(filter, colliders[other].filter) &&
+                SDL_HasIntersection(&box, &this->boxes[other])) {
+                pairs.emplace_back(collider, other);
+            }
+        }
+
+        // A pair of awake stationary colliders is found from both sides, so it is kept from the
+        // lower index only, like a pair of awake moving ones
+        results.clear();
+        this->static_tree.Query(box, results);
+        for (uint32_t leaf : results) {
+            uint32_t other = this->static_colliders[leaf];
+            if (other > collider && CanCollide(filter, colliders[other].filter) &&
+                SDL_HasIntersection(&box, &this->boxes[other])) {
+                pairs.emplace_back(collider, other);
+            }
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+}
+
+void Broadphase::QueryBox(SDL_Rect box, std::vector<uint32_t> &results) {
+    if (this->mode == BroadphaseMode::Grid) {
+        this->grid.Query(box, results);
+        return;
+    }
+
+    this->dynamic_tree.Query(box, results);
+    std::vector<uint32_t> &leaves = query_leaves;
+    leaves.clear();
+    this->static_tree.Query(box, leaves);
+    for (uint32_t leaf : leaves) {
+        results.push_back(this->static_colliders[leaf]);
+    }
+}
+
+// The grid has no cells along a segment, so it is queried with the box around the segment
+void Broadphase::QueryRay(Position start, Position end, std::vector<uint32_t> &results) {
+    if (this->mode == BroadphaseMode::Grid) {
+        int min_x = static_cast<int>(std::floor(std::min(start.x, end.x)));
+        int min_y = static_cast<int>(std::floor(std::min(start.y, end.y)));
+        int max_x = static_cast<int>(std::floor(std::max(start.x, end.x)));
+        int max_y = static_cast<int>(std::floor(std::max(start.y, end.y)));
+        this->grid.Query(SDL_Rect{min_x, min_y, max_x - min_x + 1, max_y - min_y + 1}, results);
+        return;
+    }
+
+    this->dynamic_tree.RayCast(start, end, results);
+    std::vector<uint32_t> &leaves = query_leaves;
+    leaves.clear();
+    this->static_tree.RayCast(start, end, leaves);
+    for (uint32_t leaf : leaves) {
+        results.push_back(this->static_colliders[leaf]);
+    }
+}
+
+// Stationary colliders normally keep their boxes, so the tree is only rebuilt when one of them is
+// added, removed or moved
+void Broadphase::UpdateStaticTree(const std::vector<Collider> &colliders) {
+    ZoneScoped;
+
+    this->static_colliders.clear();
+    bool changed = false;
+    for (uint32_t i = 0; i < uint32_t(colliders.size()); i++) {
+        if (!IsStatic(colliders[i])) {
+            continue;
+        }
+
+        size_t leaf = this->static_colliders.size();
+        this->static_colliders.push_back(i);
+        changed = changed || leaf >= this->static_leaves.size() ||
+                  this->static_leaves[leaf].first != colliders[i].entity ||
+                  !SameBox(this->static_leaves[leaf].second, this->boxes[i]);
+    }
+    if (!changed && this->static_colliders.size() == this->static_leaves.size()) {
+        return;
+    }
+
+    std::vector<SDL_Rect> leaf_boxes;
+    this->static_leaves.clear();
+    for (uint32_t collider : this->static_colliders) {
+        this->static_leaves.emplace_back(colliders[collider].entity, this->boxes[collider]);
+        leaf_boxes.push_back(this->boxes[collider]);
+    }
+    this->static_tree.Build(leaf_boxes);
+}
+
+// Moving colliders keep their proxy from step to step. Proxies of entities that were not seen this
+// step, because they were removed or became stationary, are destroyed.
+void Broadphase::UpdateDynamicTree(const std::vector<Collider> &colliders) {
+    ZoneScoped;
+
+    this->step++;
+    this->dynamic_colliders.clear();
+    for (uint32_t i = 0; i < uint32_t(colliders.size()); i++) {
+        if (IsStatic(colliders[i])) {
+            continue;
+        }
+
+        this->dynamic_colliders.push_back(i);
+        auto result = this->dynamic_proxies.try_emplace(colliders[i].entity, -1, this->step);
+        std::pair<int, uint64_t> &proxy = result.first->second;
+        if (result.second) {
+            proxy.first = this->dynamic_tree.CreateProxy(this->boxes[i], i);
+        } else {
+            this->dynamic_tree.MoveProxy(proxy.first, this->boxes[i]);
+            this->dynamic_tree.SetUser(proxy.first, i);
+            proxy.second = this->step;
+        }
+    }
+
+    for (auto iterator = this->dynamic_proxies.begin(); iterator != this->dynamic_proxies.end();) {
+        if (iterator->second.second != this->step) {
+            this->dynamic_tree.DestroyProxy(iterator->second.first);
+            iterator = this->dynamic_proxies.erase(iterator);
+        } else {
+            ++iterator;
+        }
+    }
+}
\ No newline at end of file
@@ -18,17 +18,56 @@ Collision::Collision(Entity *entity) {
     this->entity = entity;
     this->restitution = 0;
     this->avoid_transform = false;
+    this->layer = DEFAULT_COLLISION_LAYER;
+    this->mask = ALL_COLLISION_LAYERS;
+    this->continuous = false;
+    this->has_sweep = false;
+    this->sweep_start = Position{0, 0};
+    this->sweep_end = Position{0, 0};
+
+    EventManager::GetInstance().Register({EventType::Death}, this);
+}
 
-    EventManager::GetInstance().Register({EventType::Collision, EventType::Death}, this);
+Collision::~Collision() {
+    EventManager::GetInstance().Deregister({EventType::Death}, this);
 }
 
 float Collision::GetRestitution() { return this->restitution; }
 bool Collision::GetAvoidTransform() { return this->avoid_transform; }
+bool Collision::GetContinuous() { return this->continuous; }
+int Collision::GetLayer() { return this->layer; }
+CollisionMask Collision::GetMask() { return this->mask; }
 
 void Collision::SetRestitution(float restitution) { this->restitution = restitution; }
 void Collision::SetAvoidTransform(bool avoid_transform) { this->avoid_transform = avoid_transform; }
+void Collision::SetContinuous(bool continuous) { this->continuous = continuous; }
+void Collision::SetMask(CollisionMask mask) { this->mask = mask; }
+
+void Collision::SetLayer(int layer) {
+    if (layer < 0 || layer >= int(MAX_COLLISION_LAYERS)) {
+        Log(LogLevel::Error, "Collision layer %d is out of range", layer);
+        return;
+    }
+    this->layer = layer;
+}
+
+void Collision::SetSweep(Position start, Position end) {
+    this->has_sweep = true;
+    this->sweep_start = start;
+    this->sweep_end = end;
+}
+
+// A sweep only holds while the body is still where the integrator left it. Bodies that were moved
+// again since, for example teleported by a callback, are only tested discretely.
+bool Collision::TakeSweep(Position end, Position &start) {
+    bool valid = this->has_sweep && this->sweep_end.x == end.x && this->sweep_end.y == end.y;
+    this->has_sweep = false;
+    start = this->sweep_start;
+    return valid;
+}
 
-void Collision::HandlePairwiseCollision(Entity *collider) {
+// Called by the narrowphase for every step the pair touches, with the contact seen from this body
+void Collision::HandlePairwiseCollision(Entity *collider, const ContactManifold &manifold) {
     ZoneScoped;
 
     if (collider == nullptr) {
@@ -39,15 +78,10 @@ void Collision::HandlePairwiseCollision(Entity *collider) {
         return;
     }
 
-    if (this->entity == GetClientPlayer(Engine::GetInstance().GetNetworkInfo().id,
-                                        Engine::GetInstance().GetEntities())) {
-        if (collider->GetCategory() == EntityCategory::DeathZone) {
-            EventManager::GetInstance().RaiseDeathEvent(DeathEvent{this->entity});
-            return;
-        }
-        if (collider->GetCategory() == EntityCategory::SideBoundary) {
-            Engine::GetInstance().HandleSideBoundaries(collider);
-        }
+    if (this->entity == Engine::GetInstance().GetLocalPlayer() &&
+        collider->GetCategory() == EntityCategory::DeathZone) {
+        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{this->entity->GetId()});
+        return;
     }
 
     if (this->entity->GetComponent<Network>() != nullptr) {
@@ -59,21 +93,24 @@ void Collision::HandlePairwiseCollision(Entity *collider) {
         }
     }
 
-    int obj_x =
-        static_cast<int>(std::round(this->entity->GetComponent<Transform>()->GetPosition().x));
-    int obj_y =
-        static_cast<int>(std::round(this->entity->GetComponent<Transform>()->GetPosition().y));
-    int col_x = static_cast<int>(std::round(collider->GetComponent<Transform>()->GetPosition().x));
-    int col_y = static_cast<int>(std::round(collider->GetComponent<Transform>()->GetPosition().y));
+    Transform *obj_transform = this->entity->GetComponent<Transform>();
+    Transform *col_transform = collider->GetComponent<Transform>();
+    Position obj_position = obj_transform->GetPosition();
+    Position col_position = col_transform->GetPosition();
+    Size obj_size = obj_transform->GetSize();
+    Size col_size = col_transform->GetSize();
+
+    int obj_x = static_cast<int>(std::round(obj_position.x));
+    int obj_y = static_cast<int>(std::round(obj_position.y));
+    int col_x = static_cast<int>(std::round(col_position.x));
+    int col_y = static_cast<int>(std::round(col_position.y));
 
-    int obj_width = this->entity->GetComponent<Transform>()->GetSize().width;
-    int obj_height = this->entity->GetComponent<Transform>()->GetSize().height;
-    int col_width = collider->GetComponent<Transform>()->GetSize().width;
-    int col_height = collider->GetComponent<Transform>()->GetSize().height;
+    int obj_width = obj_size.width;
+    int obj_height = obj_size.height;
+    int col_width = col_size.width;
+    int col_height = col_size.height;
 
-    SDL_Rect rect_1 = {obj_x, obj_y, obj_width, obj_height};
-    SDL_Rect rect_2 = {col_x, col_y, col_width, col_height};
-    Overlap overlap = GetOverlap(rect_1, rect_2);
+    Overlap overlap = manifold.side;
 
     int pos_x = 0, pos_y = 0;
 
@@ -91,26 +128,26 @@ void Collision::HandlePairwiseCollision(Entity *collider) {
         pos_y = col_y + col_height;
     }
 
-    if (this->entity->GetComponent<Physics>()) {
+    Physics *physics = this->entity->GetComponent<Physics>();
+    if (physics) {
         if (this->GetAvoidTransform()) {
             return;
         }
 
-        this->entity->GetComponent<Transform>()->SetPosition(Position{float(pos_x), float(pos_y)});
+        obj_transform->Move(Position{float(pos_x), float(pos_y)});
 
-        float vel_x = this->entity->GetComponent<Physics>()->GetVelocity().x;
-        float vel_y = this->entity->GetComponent<Physics>()->GetVelocity().y;
+        Velocity velocity = physics->GetVelocity();
+        float vel_x = velocity.x;
+        float vel_y = velocity.y;
 
-        if (collider->GetCategory() != EntityCategory::SideBoundary) {
-            if (overlap == Overlap::Left || overlap == Overlap::Right) {
-                vel_x *= -this->GetRestitution();
-            }
-            if (overlap == Overlap::Top || overlap == Overlap::Bottom) {
-                vel_y *= -this->GetRestitution();
-            }
+        if (overlap == Overlap::Left || overlap == Overlap::Right) {
+            vel_x *= -this->GetRestitution();
+        }
+        if (overlap == Overlap::Top || overlap == Overlap::Bottom) {
+            vel_y *= -this->GetRestitution();
         }
 
-        this->entity->GetComponent<Physics>()->SetVelocity(Velocity{vel_x, vel_y});
+        physics->SetVelocity(Velocity{vel_x, vel_y});
     }
 }
 
@@ -120,29 +157,13 @@ void Collision::OnEvent(Event event) {
     EventType event_type = event.type;
 
     switch (event_type) {
-    case EventType::Collision: {
-        CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
-        Entity *collider = nullptr;
-        if (collision_event) {
-            if (this->entity == collision_event->collider_1) {
-                collider = collision_event->collider_2;
-            } else if (this->entity == collision_event->collider_2) {
-                collider = collision_event->collider_1;
-            }
-            this->HandlePairwiseCollision(collider);
-        }
-
-        break;
-    }
-
     case EventType::Death: {
         DeathEvent *death_event = std::get_if<DeathEvent>(&(event.data));
         if (death_event) {
-            if (this->entity == GetClientPlayer(Engine::GetInstance().GetNetworkInfo().id,
-                                                Engine::GetInstance().GetEntities())) {
-                if (this->entity == death_event->entity) {
+            if (this->entity == Engine::GetInstance().GetLocalPlayer()) {
+                if (this->entity->GetId() == death_event->entity) {
                     this->entity->GetComponent<Render>()->SetVisible(false);
-                    EventManager::GetInstance().RaiseSpawnEvent(SpawnEvent{this->entity});
+                    EventManager::GetInstance().RaiseSpawnEvent(SpawnEvent{this->entity->GetId()});
                 }
             }
         }
@@ -0,0 +1,76 @@
+#include "ContactCache.hpp"
+#include "Entity.hpp"
+#include "EntityDirectory.hpp"
+#include "Transform.hpp"
+#include "Types.hpp"
+
+#include "Profile.hpp"
+PROFILED;
+
+static uint64_t PackEntityId(EntityId entity_id) {
+    return (static_cast<uint64_t>(entity_id.generation) << 32) | entity_id.index;
+}
+
+static std::pair<uint64_t, uint64_t> GetContactKey(EntityId collider_1, EntityId collider_2) {
+    return {PackEntityId(collider_1), PackEntityId(collider_2)};
+}
+
+size_t ContactCache::ContactKeyHash::operator()(const std::pair<uint64_t, uint64_t> &key) const {
+    return std::hash<uint64_t>()(key.first * 0x9e3779b97f4a7c15ull ^ key.second);
+}
+
+ContactCache::ContactCache() { this->step = 0; }
+
+// Entities that were removed are never asleep, so their contacts end
+static bool IsAsleep(EntityId entity_id) {
+    Entity *entity = EntityDirectory::GetInstance().Resolve(entity_id);
+    if (entity == nullptr || entity->GetComponent<Transform>() == nullptr) {
+        return false;
+    }
+    return entity->GetComponent<Transform>()->IsSleeping();
+}
+
+// Called before any contact of the step wakes a body, so contacts between bodies that slept
+// through the collision test are carried over even if one of them is woken later in the step
+void ContactCache::BeginStep() {
+    ZoneScoped;
+
+    this->step++;
+    for (auto &[key, contact] : this->contacts) {
+        if (IsAsleep(contact.collider_1) && IsAsleep(contact.collider_2)) {
+            contact.step = this->step;
+        }
+    }
+}
+
+ContactPhase ContactCache::Touch(EntityId collider_1, EntityId collider_2,
+                                 const ContactManifold &manifold) {
+    Contact contact = Contact{collider_1, collider_2, manifold, this->step};
+    auto inserted = this->contacts.try_emplace(GetContactKey(collider_1, collider_2), contact);
+    if (inserted.second) {
+        return ContactPhase::Enter;
+    }
+
+    inserted.first->second.manifold = manifold;
+    inserted.first->second.step = this->step;
+    return ContactPhase::Stay;
+}
+
+void ContactCache::TakeExits(std::vector<CollisionEvent> &exits) {
+    ZoneScoped;
+
+    exits.clear();
+    for (auto iterator = this->contacts.begin(); iterator != this->contacts.end();) {
+        const Contact &contact = iterator->second;
+        if (contact.step == this->step) {
+            ++iterator;
+            continue;
+        }
+
+        exits.push_back(CollisionEvent{contact.collider_1, contact.collider_2, ContactPhase::Exit,
+                                       contact.manifold});
+        iterator = this->contacts.erase(iterator);
+    }
+}
+
+void ContactCache::Clear() { this->contacts.clear(); }
\ No newline at end of file
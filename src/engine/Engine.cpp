@@ -1,11 +1,18 @@
 #include "Engine.hpp"
+#include "AabbOverlap.hpp"
 #include "Collision.hpp"
+#include "ComponentStorage.hpp"
 #include "EngineHandler.hpp"
 #include "Entity.hpp"
+#include "EntityDirectory.hpp"
+#include "EpochManager.hpp"
 #include "EventManager.hpp"
 #include "Handler.hpp"
 #include "Input.hpp"
+#include "Integrator.hpp"
+#include "JobSystem.hpp"
 #include "Json.hpp"
+#include "NameTable.hpp"
 #include "Network.hpp"
 #include "Physics.hpp"
 #include "Render.hpp"
@@ -22,12 +29,14 @@
 #include "Types.hpp"
 #include "Utils.hpp"
 #include <algorithm>
+#include <chrono>
 #include <climits>
 #include <csignal>
 #include <cstring>
 #include <memory>
 #include <string>
 #include <thread>
+#include <unordered_set>
 #include <vector>
 #include <zmq.hpp>
 
@@ -52,10 +61,16 @@ Engine::Engine() {
     this->engine_handler = std::make_unique<EngineHandler>();
     this->encoding = Encoding::Struct;
     this->players_connected.store(0);
+    this->local_player.store(nullptr);
     this->background_color = Color{0, 0, 0, 255};
     this->show_player_border = false;
     this->player_textures = INT_MAX;
     this->max_players = INT_MAX;
+    this->tick_rate = 0;
+    this->max_substeps = DEFAULT_MAX_SUBSTEPS;
+    this->step_accumulator = 0;
+    this->interpolation_alpha = 1;
+    this->collision_matrix.fill(ALL_COLLISION_LAYERS);
 
     this->camera = std::make_shared<Entity>("camera", EntityCategory::Camera);
     this->camera->AddComponent<Transform>();
@@ -64,6 +79,7 @@ Engine::Engine() {
 
     Replay::GetInstance().SetCamera(this->camera);
 
+    this->entity_snapshot.store(new EntitySnapshot());
     this->show_zone_borders = false;
     this->side_boundary_color = Color{0, 0, 255, 128};
     this->spawn_point_color = Color{0, 255, 0, 128};
@@ -80,6 +96,13 @@ Engine::Engine() {
 bool Engine::Init() {
     ZoneScoped;
 
+    Log(LogLevel::Info, "Integrating physics with the %s kernel",
+        Integrator::GetInstance().GetKernelName());
+    Log(LogLevel::Info, "Testing collision overlaps with the %s kernel",
+        AabbOverlap::GetInstance().GetKernelName());
+    Log(LogLevel::Info, "Running jobs on %zu worker threads",
+        JobSystem::GetInstance().GetWorkerCount());
+
     if (this->network_info.mode == NetworkMode::Single &&
         this->network_info.role == NetworkRole::Client) {
         return this->InitSingleClient();
@@ -137,7 +160,8 @@ void Engine::CSServerClientThread(int player_id) {
             std::memcpy(reply.data(), ack.c_str(), ack.size());
             client_socket.send(reply, zmq::send_flags::none);
 
-            Entity *entity = GetEntityByName(entity_update.name, this->GetEntities());
+            EpochGuard guard;
+            Entity *entity = this->FindEntity(entity_update.name);
             if (entity != nullptr) {
                 if (!entity_update.active) {
                     entity->GetComponent<Network>()->SetActive(false);
@@ -145,7 +169,7 @@ void Engine::CSServerClientThread(int player_id) {
                 if (!Replay::GetInstance().GetIsReplaying()) {
                     bool ignore_change = !entity_update.active;
                     EventManager::GetInstance().RaiseMoveEvent(
-                        MoveEvent{entity, entity_update.position, entity_update.angle},
+                        MoveEvent{entity->GetId(), entity_update.position, entity_update.angle},
                         ignore_change);
                 }
             }
@@ -172,8 +196,9 @@ void Engine::CSServerBroadcastUpdates(Entity *entity) {
         EntityUpdate entity_update;
         std::snprintf(entity_update.name, sizeof(entity_update.name), "%s",
                       entity->GetName().c_str());
-        entity_update.position = entity->GetComponent<Transform>()->GetPosition();
-        entity_update.angle = entity->GetComponent<Transform>()->GetAngle();
+        Pose pose = entity->GetComponent<Transform>()->GetPose();
+        entity_update.position = pose.position;
+        entity_update.angle = pose.angle;
 
         if (!entity->GetComponent<Network>()->GetActive()) {
             entity_update.active = false;
@@ -361,14 +386,16 @@ bool Engine::InitCSClient() {
 void Engine::P2PHostBroadcastPlayers() {
     ZoneScoped;
 
-    for (Entity *entity : this->GetNetworkedEntities()) {
+    EpochGuard guard;
+    for (Entity *entity : this->GetEntitySnapshot()->networked_entities) {
         try {
             if (entity->GetComponent<Network>()->GetOwner() == NetworkRole::Peer) {
                 EntityUpdate entity_update;
                 std::snprintf(entity_update.name, sizeof(entity_update.name), "%s",
                               entity->GetName().c_str());
-                entity_update.position = entity->GetComponent<Transform>()->GetPosition();
-                entity_update.angle = entity->GetComponent<Transform>()->GetAngle();
+                Pose pose = entity->GetComponent<Transform>()->GetPose();
+                entity_update.position = pose.position;
+                entity_update.angle = pose.angle;
                 std::snprintf(entity_update.player_address, sizeof(entity_update.player_address),
                               "%s", entity->GetComponent<Network>()->GetPlayerAddress().c_str());
 
@@ -386,7 +413,8 @@ void Engine::P2PHostBroadcastPlayers() {
 void Engine::CSServerBroadcastPlayers() {
     ZoneScoped;
 
-    for (Entity *entity : this->GetNetworkedEntities()) {
+    EpochGuard guard;
+    for (Entity *entity : this->GetEntitySnapshot()->networked_entities) {
         try {
             // don't broadcast the default player entity, i.e the entity without an id in it
             if (entity->GetCategory() == EntityCategory::Controllable &&
@@ -398,8 +426,9 @@ void Engine::CSServerBroadcastPlayers() {
                 EntityUpdate entity_update;
                 std::snprintf(entity_update.name, sizeof(entity_update.name), "%s",
                               entity->GetName().c_str());
-                entity_update.position = entity->GetComponent<Transform>()->GetPosition();
-                entity_update.angle = entity->GetComponent<Transform>()->GetAngle();
+                Pose pose = entity->GetComponent<Transform>()->GetPose();
+                entity_update.position = pose.position;
+                entity_update.angle = pose.angle;
                 std::snprintf(entity_update.player_address, sizeof(entity_update.player_address),
                               "%s", entity->GetComponent<Network>()->GetPlayerAddress().c_str());
 
@@ -541,6 +570,8 @@ bool Engine::InitP2PPeer() {
 void Engine::Start() {
     ZoneScoped;
 
+    this->ApplyEntityCommands();
+
     if (this->network_info.mode == NetworkMode::Single &&
         this->network_info.role == NetworkRole::Client) {
         this->StartSingleClient();
@@ -572,12 +603,11 @@ void Engine::StartSingleClient() {
         app->quit.store(this->HandleQuitEvent());
         EventManager::GetInstance().ProcessEvents();
         this->input->Process();
-        this->GetTimeDelta();
-        this->ApplyEntityPhysicsAndUpdates();
-        this->TestCollision();
-        this->Update();
+        this->ApplyEntityCommands();
+        this->Simulate();
         this->RecordEvents();
         this->RenderScene();
+        this->ReclaimRemovedEntities();
     }
 
     this->Shutdown();
@@ -586,6 +616,9 @@ void Engine::StartSingleClient() {
 void Engine::StartCSServer() {
     ZoneScoped;
 
+    if (this->tick_rate <= 0) {
+        this->tick_rate = SERVER_TICK_RATE;
+    }
     this->engine_timeline->SetFrameTime(FrameTime{0, this->engine_timeline->GetTime(), 0});
 
     // Engine loop
@@ -593,10 +626,10 @@ void Engine::StartCSServer() {
         ZoneScopedNC("EngineLoop", 0xff4500);
 
         EventManager::GetInstance().ProcessEvents();
-        this->GetTimeDelta();
-        this->ApplyEntityPhysicsAndUpdates();
-        this->TestCollision();
-        this->Update();
+        this->ApplyEntityCommands();
+        this->Simulate();
+        this->ReclaimRemovedEntities();
+        this->WaitForNextTick();
     }
 
     this->zmq_context.shutdown();
@@ -613,7 +646,8 @@ Entity *Engine::CreateNewPlayer(int player_id, std::string player_address) {
     bool is_p2p = this->network_info.mode == NetworkMode::PeerToPeer;
     bool is_host = this->network_info.role == NetworkRole::Host;
 
-    Entity *controllable = GetControllable(this->GetEntities());
+    EpochGuard guard;
+    Entity *controllable = GetControllable(this->GetEntitySnapshot()->entities);
     std::string player_name = Split(controllable->GetName(), '_')[0];
     player_name += "_" + std::to_string(player_id);
 
@@ -628,6 +662,7 @@ Entity *Engine::CreateNewPlayer(int player_id, std::string player_address) {
         if (this->show_player_border) {
             controllable->GetComponent<Render>()->SetBorder(Border{true, Color{0, 0, 0, 255}});
         }
+        this->RegisterPlayer(player_id, controllable);
         return controllable;
     }
     if (player_id != this->network_info.id) {
@@ -666,6 +701,7 @@ Entity *Engine::CreateNewPlayer(int player_id, std::string player_address) {
         }
         SetPlayerTexture(player, player_id, this->player_textures);
 
+        this->RegisterPlayer(player_id, player);
         this->AddEntity(player);
         return player;
     }
@@ -673,6 +709,38 @@ Entity *Engine::CreateNewPlayer(int player_id, std::string player_address) {
     return nullptr;
 }
 
+// Players are looked up by network id on every frame and by every network thread, so the registry
+// is kept up to date as players are created and removed instead of being rebuilt from their names
+void Engine::RegisterPlayer(int player_id, Entity *player) {
+    std::lock_guard<std::mutex> lock(this->players_mutex);
+    this->players[player_id] = player;
+    if (player_id == this->network_info.id) {
+        this->local_player.store(player);
+    }
+}
+
+void Engine::UnregisterPlayer(Entity *entity) {
+    std::lock_guard<std::mutex> lock(this->players_mutex);
+    for (auto iterator = this->players.begin(); iterator != this->players.end(); iterator++) {
+        if (iterator->second == entity) {
+            this->players.erase(iterator);
+            break;
+        }
+    }
+
+    Entity *expected = entity;
+    this->local_player.compare_exchange_strong(expected, nullptr);
+}
+
+Entity *Engine::GetPlayer(int player_id) {
+    std::lock_guard<std::mutex> lock(this->players_mutex);
+    auto iterator = this->players.find(player_id);
+    return iterator != this->players.end() ? iterator->second : nullptr;
+}
+
+// Network threads must hold an EpochGuard for as long as they use the returned player
+Entity *Engine::GetLocalPlayer() { return this->local_player.load(); }
+
 void Engine::CSClientReceiveBroadcastThread() {
     TracySetThreadName("CSClientReceiveBroadcastThread");
 
@@ -698,20 +766,19 @@ void Engine::CSClientReceiveBroadcastThread() {
             if (res) {
                 EntityUpdate entity_update;
                 this->DecodeMessage(message, entity_update);
-                Entity *entity = GetEntityByName(entity_update.name, this->GetEntities());
+                EpochGuard guard;
+                Entity *entity = this->FindEntity(entity_update.name);
                 // If the entity received does not already exist in the client, create it. Occurs
                 // whenever a new client joins the game
                 if (entity == nullptr) {
                     int player_id = GetPlayerIdFromName(entity_update.name);
                     entity = this->CreateNewPlayer(player_id);
                 }
-                Entity *player = GetClientPlayer(this->network_info.id, this->GetEntities());
-
-                if (entity->GetName() != player->GetName()) {
+                if (entity != this->GetLocalPlayer()) {
                     if (entity_update.active) {
                         if (!Replay::GetInstance().GetIsReplaying()) {
-                            EventManager::GetInstance().RaiseMoveEvent(
-                                MoveEvent{entity, entity_update.position, entity_update.angle});
+                            EventManager::GetInstance().RaiseMoveEvent(MoveEvent{
+                                entity->GetId(), entity_update.position, entity_update.angle});
                         }
                     } else {
                         this->RemoveEntity(entity);
@@ -729,13 +796,15 @@ void Engine::CSClientReceiveBroadcastThread() {
 void Engine::CSClientSendUpdate() {
     ZoneScoped;
 
+    EpochGuard guard;
     try {
-        Entity *player = GetClientPlayer(this->network_info.id, this->GetEntities());
+        Entity *player = this->GetLocalPlayer();
         EntityUpdate entity_update;
         std::snprintf(entity_update.name, sizeof(entity_update.name), "%s",
                       player->GetName().c_str());
-        entity_update.position = player->GetComponent<Transform>()->GetPosition();
-        entity_update.angle = player->GetComponent<Transform>()->GetAngle();
+        Pose pose = player->GetComponent<Transform>()->GetPose();
+        entity_update.position = pose.position;
+        entity_update.angle = pose.angle;
 
         zmq::message_t update;
         this->EncodeMessage(entity_update, update);
@@ -755,13 +824,15 @@ void Engine::CSClientSendUpdate() {
 void Engine::SendInactiveUpdate() {
     ZoneScoped;
 
+    EpochGuard guard;
     try {
-        Entity *player = GetClientPlayer(this->network_info.id, this->GetEntities());
+        Entity *player = this->GetLocalPlayer();
         EntityUpdate entity_update;
         std::snprintf(entity_update.name, sizeof(entity_update.name), "%s",
                       player->GetName().c_str());
-        entity_update.position = player->GetComponent<Transform>()->GetPosition();
-        entity_update.angle = player->GetComponent<Transform>()->GetAngle();
+        Pose pose = player->GetComponent<Transform>()->GetPose();
+        entity_update.position = pose.position;
+        entity_update.angle = pose.angle;
         entity_update.active = false;
 
         zmq::message_t update;
@@ -851,12 +922,11 @@ void Engine::StartCSClient() {
         app->quit.store(this->HandleQuitEvent());
         EventManager::GetInstance().ProcessEvents();
         this->input->Process();
-        this->GetTimeDelta();
-        this->ApplyEntityPhysicsAndUpdates();
-        this->TestCollision();
-        this->Update();
+        this->ApplyEntityCommands();
+        this->Simulate();
         this->RecordEvents();
         this->RenderScene();
+        this->ReclaimRemovedEntities();
     }
     EventManager::GetInstance().RaiseLeaveEvent(LeaveEvent{});
 
@@ -878,8 +948,9 @@ void Engine::P2PBroadcastUpdates(Entity *entity) {
         EntityUpdate entity_update;
         std::snprintf(entity_update.name, sizeof(entity_update.name), "%s",
                       entity->GetName().c_str());
-        entity_update.position = entity->GetComponent<Transform>()->GetPosition();
-        entity_update.angle = entity->GetComponent<Transform>()->GetAngle();
+        Pose pose = entity->GetComponent<Transform>()->GetPose();
+        entity_update.position = pose.position;
+        entity_update.angle = pose.angle;
 
         zmq::message_t broadcast_update;
         this->EncodeMessage(entity_update, broadcast_update);
@@ -888,7 +959,7 @@ void Engine::P2PBroadcastUpdates(Entity *entity) {
             // The host peer broadcasts the positions of all host governed entities
             this->host_broadcast_socket.send(broadcast_update, zmq::send_flags::none);
         } else if (this->network_info.role == NetworkRole::Peer &&
-                   this->network_info.id == GetPlayerIdFromName(entity->GetName())) {
+                   entity == this->GetLocalPlayer()) {
             // The other peers broadcast the position of its own controllable player
             this->peer_broadcast_socket.send(broadcast_update, zmq::send_flags::none);
         }
@@ -924,11 +995,16 @@ void Engine::P2PReceiveBroadcastFromPeerThread(int player_id, std::string player
             if (res) {
                 EntityUpdate entity_update;
                 this->DecodeMessage(message, entity_update);
-                Entity *entity = GetEntityByName(entity_update.name, this->GetEntities());
+                EpochGuard guard;
+                Entity *entity = this->FindEntity(entity_update.name);
+                if (entity == nullptr) {
+                    continue;
+                }
+
                 if (entity_update.active) {
                     if (!Replay::GetInstance().GetIsReplaying()) {
-                        EventManager::GetInstance().RaiseMoveEvent(
-                            MoveEvent{entity, entity_update.position, entity_update.angle});
+                        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{
+                            entity->GetId(), entity_update.position, entity_update.angle});
                     }
                 } else {
                     this->RemoveEntity(entity);
@@ -968,7 +1044,8 @@ void Engine::P2PReceiveBroadcastFromHostThread() {
             if (res) {
                 EntityUpdate entity_update;
                 this->DecodeMessage(message, entity_update);
-                Entity *entity = GetEntityByName(entity_update.name, this->GetEntities());
+                EpochGuard guard;
+                Entity *entity = this->FindEntity(entity_update.name);
                 // If the entity received does not already exist in the client, create it. Occurs
                 // whenever a new client joins the game
                 if (entity == nullptr) {
@@ -982,13 +1059,11 @@ void Engine::P2PReceiveBroadcastFromHostThread() {
                         });
                     }
                 }
-                Entity *player = GetClientPlayer(this->network_info.id, this->GetEntities());
-
-                if (entity->GetName() != player->GetName()) {
+                if (entity != this->GetLocalPlayer()) {
                     if (entity_update.active) {
                         if (!Replay::GetInstance().GetIsReplaying()) {
-                            EventManager::GetInstance().RaiseMoveEvent(
-                                MoveEvent{entity, entity_update.position, entity_update.angle});
+                            EventManager::GetInstance().RaiseMoveEvent(MoveEvent{
+                                entity->GetId(), entity_update.position, entity_update.angle});
                         }
                     } else {
                         this->RemoveEntity(entity);
@@ -1029,12 +1104,11 @@ void Engine::StartP2P() {
         app->quit.store(this->HandleQuitEvent());
         EventManager::GetInstance().ProcessEvents();
         this->input->Process();
-        this->GetTimeDelta();
-        this->ApplyEntityPhysicsAndUpdates();
-        this->TestCollision();
-        this->Update();
+        this->ApplyEntityCommands();
+        this->Simulate();
         this->RecordEvents();
         this->RenderScene();
+        this->ReclaimRemovedEntities();
     }
     EventManager::GetInstance().RaiseLeaveEvent(LeaveEvent{});
 
@@ -1147,26 +1221,35 @@ void Engine::ToggleShowZoneBorders() {
     ZoneScoped;
 
     this->show_zone_borders = !this->show_zone_borders;
+}
 
-    std::vector<Entity *> entities = this->GetEntities();
+void Engine::SetPlayerTextures(int player_textures) { this->player_textures = player_textures; }
 
-    for (Entity *entity : entities) {
-        bool is_side_boundary = entity->GetCategory() == EntityCategory::SideBoundary &&
-                                (entity->GetName().find("side_boundary_") == 0);
-        bool is_spawn_point = entity->GetCategory() == EntityCategory::SpawnPoint &&
-                              (entity->GetName().find("spawn_point_") == 0);
-        bool is_death_zone = entity->GetCategory() == EntityCategory::DeathZone &&
-                             (entity->GetName().find("death_zone_") == 0);
+void Engine::SetMaxPlayers(int max_players) { this->max_players = max_players; }
+void Engine::SetTickRate(int tick_rate) { this->tick_rate = std::max(tick_rate, 0); }
+void Engine::SetMaxSubsteps(int max_substeps) { this->max_substeps = std::max(max_substeps, 1); }
+void Engine::SetBroadphaseMode(BroadphaseMode mode) { this->broadphase.SetMode(mode); }
+void Engine::SetCollisionCellSize(int cell_size) { this->broadphase.SetCellSize(cell_size); }
+
+// Turns testing between two layers on or off in both directions, on top of the masks of the
+// colliders themselves
+void Engine::SetLayersCollide(int layer_1, int layer_2, bool collide) {
+    if (layer_1 < 0 || layer_1 >= int(MAX_COLLISION_LAYERS) || layer_2 < 0 ||
+        layer_2 >= int(MAX_COLLISION_LAYERS)) {
+        Log(LogLevel::Error, "Collision layers %d and %d are out of range", layer_1, layer_2);
+        return;
+    }
 
-        if (is_side_boundary || is_spawn_point || is_death_zone) {
-            entity->GetComponent<Render>()->SetVisible(this->show_zone_borders);
-        }
+    if (collide) {
+        this->collision_matrix[layer_1] |= CollisionMaskOf(layer_2);
+        this->collision_matrix[layer_2] |= CollisionMaskOf(layer_1);
+    } else {
+        this->collision_matrix[layer_1] &= ~CollisionMaskOf(layer_2);
+        this->collision_matrix[layer_2] &= ~CollisionMaskOf(layer_1);
     }
 }
 
-void Engine::SetPlayerTextures(int player_textures) { this->player_textures = player_textures; }
-
-void Engine::SetMaxPlayers(int max_players) { this->max_players = max_players; }
+double Engine::GetInterpolationAlpha() { return this->interpolation_alpha; }
 
 void Engine::ShowWelcomeScreen() {
     ZoneScoped;
@@ -1179,119 +1262,572 @@ void Engine::ShowWelcomeScreen() {
     SDL_RenderPresent(app->renderer);
 }
 
+// Copy of the published entity snapshot, safe to take from any thread
 std::vector<Entity *> Engine::GetEntities() {
-    std::lock_guard<std::mutex> lock(this->entities_mutex);
-    return this->entities;
+    EpochGuard guard;
+    return this->GetEntitySnapshot()->entities;
+}
+
+// The snapshot is immutable and only replaced by the engine loop, so reading it never takes a lock.
+// Callers on other threads hold an EpochGuard for as long as they use the snapshot or the entities
+// in it.
+const EntitySnapshot *Engine::GetEntitySnapshot() { return this->entity_snapshot.load(); }
+
+// The live entity list itself. Only the engine loop changes it, so only code running on the engine
+// loop's thread may use it.
+const std::vector<Entity *> &Engine::GetLiveEntities() { return this->entities; }
+
+// Looks an entity up by name among the published entities and the ones waiting to be added or
+// renamed, so network threads do not create a second copy of a player that joined during the
+// current frame. A name that was never interned cannot belong to any entity, so unknown names never
+// touch the entity lists. Callers on other threads hold an EpochGuard while they use the result.
+Entity *Engine::FindEntity(std::string name) {
+    uint32_t name_id;
+    if (!NameTable::GetInstance().Find(name, name_id)) {
+        return nullptr;
+    }
+
+    {
+        EpochGuard guard;
+        const EntitySnapshot *snapshot = this->GetEntitySnapshot();
+        const std::vector<std::pair<uint32_t, Entity *>> &names = snapshot->entity_names;
+        auto iterator = std::lower_bound(
+            names.begin(), names.end(), name_id,
+            [](const std::pair<uint32_t, Entity *> &name, uint32_t id) { return name.first < id; });
+        // A renamed entity stays under its old name id until the next snapshot, and that id may
+        // already have been handed to a different name
+        for (; iterator != names.end() && iterator->first == name_id; iterator++) {
+            if (iterator->second->GetNameId() == name_id) {
+                return iterator->second;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(this->entity_commands_mutex);
+    for (const EntityCommand &command : this->entity_commands) {
+        if (command.type != EntityCommandType::Remove && command.entity->GetNameId() == name_id) {
+            return command.entity;
+        }
+    }
+    return nullptr;
+}
+
+// The published snapshot picks the new name up at the next sync point
+void Engine::ReindexEntityName(Entity *entity) {
+    if (entity->IsInEngine()) {
+        this->RefreshEntity(entity);
+    }
 }
 
+// Copy of the published networked entities, safe to take from any thread
 std::vector<Entity *> Engine::GetNetworkedEntities() {
-    std::vector<Entity *> networked_entities;
-    for (Entity *entity : this->GetEntities()) {
-        if (entity->GetComponent<Network>() != nullptr) {
-            networked_entities.push_back(entity);
+    EpochGuard guard;
+    return this->GetEntitySnapshot()->networked_entities;
+}
+
+// Views are created on first use and then kept up to date as entities enter and leave the engine or
+// change their components and tags, so iterating one only costs the number of entities it matches
+const std::vector<Entity *> &Engine::QueryComponents(ComponentMask mask) {
+    std::lock_guard<std::mutex> lock(this->entities_mutex);
+    return this->GetComponentView(mask);
+}
+
+const std::vector<Entity *> &Engine::QueryCategory(EntityCategory category) {
+    return this->category_views[size_t(category)];
+}
+
+// Returns the tag registered under the name, registering it on first use. Returns -1 once all
+// MAX_TAGS tags are taken.
+int Engine::RegisterTag(std::string name) {
+    std::lock_guard<std::mutex> lock(this->tags_mutex);
+
+    auto iterator = this->tag_ids.find(name);
+    if (iterator != this->tag_ids.end()) {
+        return iterator->second;
+    }
+
+    if (this->tag_ids.size() >= MAX_TAGS) {
+        Log(LogLevel::Error, "Could not register tag %s, all %zu tags are taken", name.c_str(),
+            MAX_TAGS);
+        return -1;
+    }
+
+    int tag = int(this->tag_ids.size());
+    this->tag_ids.emplace(name, tag);
+    return tag;
+}
+
+const std::vector<Entity *> &Engine::QueryTag(int tag) {
+    static const std::vector<Entity *> no_entities;
+    if (tag < 0 || tag >= int(MAX_TAGS)) {
+        return no_entities;
+    }
+    return this->tag_views[tag];
+}
+
+// Spatial queries keep their scratch per thread, so parallel update callbacks can make them too
+static thread_local std::vector<uint32_t> query_candidates;
+
+// Candidates come from the last collision test, so colliders of entities that were removed since,
+// or that were dropped along with every collider, are skipped
+static Entity *GetQueryResult(const std::vector<Collider> &colliders, uint32_t index,
+                              CollisionMask mask) {
+    if (index >= colliders.size() || (colliders[index].filter.layer & mask) == 0) {
+        return nullptr;
+    }
+    return EntityDirectory::GetInstance().Resolve(colliders[index].id);
+}
+
+void Engine::QueryAABB(SDL_Rect box, CollisionMask mask, std::vector<Entity *> &results) {
+    ZoneScoped;
+
+    results.clear();
+    std::vector<uint32_t> &candidates = query_candidates;
+    candidates.clear();
+    this->broadphase.QueryBox(box, candidates);
+    for (uint32_t index : candidates) {
+        Entity *entity = GetQueryResult(this->colliders, index, mask);
+        if (entity != nullptr && SDL_HasIntersection(&box, &this->colliders[index].rect)) {
+            results.push_back(entity);
         }
     }
-    return networked_entities;
 }
 
+void Engine::QueryPoint(Position point, CollisionMask mask, std::vector<Entity *> &results) {
+    ZoneScoped;
+
+    results.clear();
+    std::vector<uint32_t> &candidates = query_candidates;
+    candidates.clear();
+    this->broadphase.QueryBox(SDL_Rect{static_cast<int>(std::floor(point.x)),
+                                       static_cast<int>(std::floor(point.y)), 1, 1},
+                              candidates);
+    for (uint32_t index : candidates) {
+        Entity *entity = GetQueryResult(this->colliders, index, mask);
+        if (entity == nullptr) {
+            continue;
+        }
+
+        const SDL_Rect &rect = this->colliders[index].rect;
+        if (point.x >= rect.x && point.x < rect.x + rect.w && point.y >= rect.y &&
+            point.y < rect.y + rect.h) {
+            results.push_back(entity);
+        }
+    }
+}
+
+void Engine::Raycast(Position start, Position end, CollisionMask mask,
+                     std::vector<RaycastHit> &hits) {
+    ZoneScoped;
+
+    hits.clear();
+    std::vector<uint32_t> &candidates = query_candidates;
+    candidates.clear();
+    this->broadphase.QueryRay(start, end, candidates);
+    for (uint32_t index : candidates) {
+        Entity *entity = GetQueryResult(this->colliders, index, mask);
+        float fraction;
+        Position normal;
+        if (entity == nullptr ||
+            !GetRayHit(start, end, this->colliders[index].rect, fraction, normal)) {
+            continue;
+        }
+
+        Position point = Position{start.x + (end.x - start.x) * fraction,
+                                  start.y + (end.y - start.y) * fraction};
+        hits.push_back(RaycastHit{entity, point, normal, fraction});
+    }
+
+    std::sort(hits.begin(), hits.end(), [](const RaycastHit &hit_1, const RaycastHit &hit_2) {
+        return hit_1.fraction < hit_2.fraction;
+    });
+}
+
+static void AddToView(std::vector<Entity *> &view, Entity *entity, size_t view_slot) {
+    entity->SetViewSlot(view_slot, int(view.size()));
+    view.push_back(entity);
+}
+
+// Same swap with the last entry as EraseEntity, using the slot the entity keeps for the view
+static void RemoveFromView(std::vector<Entity *> &view, Entity *entity, size_t view_slot) {
+    int slot = entity->GetViewSlot(view_slot);
+    if (slot < 0 || slot >= int(view.size()) || view[slot] != entity) {
+        return;
+    }
+
+    Entity *last_entity = view.back();
+    view[slot] = last_entity;
+    last_entity->SetViewSlot(view_slot, slot);
+    view.pop_back();
+    entity->SetViewSlot(view_slot, -1);
+}
+
+std::vector<Entity *> &Engine::GetComponentView(ComponentMask mask) {
+    auto iterator = this->component_views.find(mask);
+    if (iterator != this->component_views.end()) {
+        return iterator->second;
+    }
+
+    std::vector<Entity *> &view = this->component_views[mask];
+    for (Entity *entity : this->entities) {
+        if ((entity->GetComponentMask() & mask) == mask) {
+            AddToView(view, entity, COMPONENT_VIEW_SLOTS + mask);
+        }
+    }
+    return view;
+}
+
+void Engine::AddToViews(Entity *entity) {
+    AddToView(this->category_views[size_t(entity->GetCategory())], entity, CATEGORY_VIEW_SLOT);
+
+    ComponentMask entity_mask = entity->GetComponentMask();
+    for (auto &[mask, view] : this->component_views) {
+        if ((entity_mask & mask) == mask) {
+            AddToView(view, entity, COMPONENT_VIEW_SLOTS + mask);
+        }
+    }
+
+    TagMask tags = entity->GetTags();
+    for (size_t tag = 0; tag < MAX_TAGS && (tags >> tag) != 0; tag++) {
+        if ((tags >> tag) & 1) {
+            AddToView(this->tag_views[tag], entity, TAG_VIEW_SLOTS + tag);
+        }
+    }
+    entity->SetIndexedTags(tags);
+}
+
+void Engine::RemoveFromViews(Entity *entity) {
+    RemoveFromView(this->category_views[size_t(entity->GetCategory())], entity,
+                   CATEGORY_VIEW_SLOT);
+    for (auto &[mask, view] : this->component_views) {
+        RemoveFromView(view, entity, COMPONENT_VIEW_SLOTS + mask);
+    }
+
+    TagMask tags = entity->GetIndexedTags();
+    for (size_t tag = 0; tag < MAX_TAGS && (tags >> tag) != 0; tag++) {
+        if ((tags >> tag) & 1) {
+            RemoveFromView(this->tag_views[tag], entity, TAG_VIEW_SLOTS + tag);
+        }
+    }
+    entity->SetIndexedTags(0);
+}
+
+// Components and tags can change on any thread, so the views are re-matched at the next sync point
+void Engine::RefreshEntity(Entity *entity) {
+    std::lock_guard<std::mutex> lock(this->entity_commands_mutex);
+    this->entity_commands.push_back(EntityCommand{EntityCommandType::Refresh, entity});
+}
+
+// Structural changes are recorded here and applied by the engine loop at its sync points, so the
+// live entity list never changes while a system or a game callback is iterating it
 void Engine::AddEntity(Entity *entity) {
+    std::lock_guard<std::mutex> lock(this->entity_commands_mutex);
+    this->entity_commands.push_back(EntityCommand{EntityCommandType::Add, entity});
+}
+
+void Engine::InsertEntity(Entity *entity) {
+    if (entity->IsInEngine()) {
+        return;
+    }
+
+    // An entity that is added back before it was reclaimed comes back with a fresh handle
+    if (this->GetEntity(entity->GetId()) != entity) {
+        std::lock_guard<std::mutex> lock(this->entities_mutex);
+        this->removed_entities.erase(
+            std::remove(this->removed_entities.begin(), this->removed_entities.end(), entity),
+            this->removed_entities.end());
+        this->retired_entities.erase(
+            std::remove_if(this->retired_entities.begin(), this->retired_entities.end(),
+                           [entity](const std::pair<uint64_t, Entity *> &retired) {
+                               return retired.second == entity;
+                           }),
+            this->retired_entities.end());
+        entity->SetId(EntityDirectory::GetInstance().Register(entity));
+    }
+
     if (entity->GetComponent<Physics>() != nullptr) {
         entity->GetComponent<Physics>()->SetEngineTimeline(this->engine_timeline);
     }
     if (entity->GetComponent<Render>() != nullptr) {
         entity->GetComponent<Render>()->SetCamera(this->camera);
     }
+    Position spawn_position;
+    if (entity->GetCategory() == EntityCategory::Controllable &&
+        this->GetSpawnPosition(this->network_info.id - 1, spawn_position)) {
+        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{entity->GetId(), spawn_position});
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->entities_mutex);
+        entity->SetEngineIndex(int(this->entities.size()));
+        this->entities.push_back(entity);
+        this->AddToViews(entity);
+    }
+
+    // Writes made before the entity was added were not tracked, so its pose starts out dirty
+    if (entity->GetComponent<Transform>() != nullptr) {
+        entity->GetComponent<Transform>()->MarkDirty(DirtyMaskOf(DirtySet::Replay) |
+                                                     DirtyMaskOf(DirtySet::Render));
+    }
+}
+
+// Side boundaries are given in screen space and scroll along with the camera
+void Engine::AddSideBoundary(Position position, Size size) {
+    this->triggers.Add(EntityCategory::SideBoundary, position, size, true);
+}
+
+void Engine::RemoveEntity(Entity *entity) {
+    if (entity == nullptr) {
+        return;
+    }
+
     if (entity->GetCategory() == EntityCategory::Controllable) {
-        Entity *spawn_point = this->GetSpawnPoint(this->network_info.id - 1);
-        if (spawn_point) {
-            EventManager::GetInstance().RaiseMoveEvent(
-                MoveEvent{entity, spawn_point->GetComponent<Transform>()->GetPosition()});
-        }
+        this->UnregisterPlayer(entity);
     }
 
+    std::lock_guard<std::mutex> lock(this->entity_commands_mutex);
+    this->entity_commands.push_back(EntityCommand{EntityCommandType::Remove, entity});
+}
+
+// Swaps the last live entity into the removed entity's place and invalidates the removed entity's
+// handle, so events that still refer to it are dropped instead of dereferencing it. The entity is
+// owned by the engine and destroyed once it is reclaimed.
+void Engine::EraseEntity(Entity *entity) {
     std::lock_guard<std::mutex> lock(this->entities_mutex);
-    this->entities.push_back(entity);
+
+    int index = entity->GetEngineIndex();
+    if (index < 0 || index >= int(this->entities.size()) || this->entities[index] != entity) {
+        return;
+    }
+
+    Entity *last_entity = this->entities.back();
+    this->entities[index] = last_entity;
+    last_entity->SetEngineIndex(index);
+    this->entities.pop_back();
+
+    entity->SetEngineIndex(-1);
+    this->UnsubscribeFromTriggers(entity);
+    this->RemoveFromViews(entity);
+    EntityDirectory::GetInstance().Release(entity->GetId());
+    this->removed_entities.push_back(entity);
 }
 
-void Engine::AddSideBoundary(Position position, Size size) {
-    size_t side_boundary_index =
-        GetEntitiesByCategory(this->GetEntities(), EntityCategory::SideBoundary).size();
-    Entity *side_boundary = new Entity("side_boundary_" + std::to_string(side_boundary_index),
-                                       EntityCategory::SideBoundary);
-    side_boundary->AddComponent<Transform>();
-    side_boundary->AddComponent<Physics>();
-    side_boundary->AddComponent<Render>();
+// Sync point for structural changes. Only the engine loop applies commands, which makes it the only
+// writer of the live entity list and lets it read the list without locking or copying it.
+void Engine::ApplyEntityCommands() {
+    ZoneScoped;
 
-    side_boundary->GetComponent<Transform>()->SetPosition(position);
-    side_boundary->GetComponent<Transform>()->SetSize(size);
-    side_boundary->GetComponent<Render>()->SetBorder(Border{true, this->side_boundary_color});
-    side_boundary->GetComponent<Render>()->SetDepth(INT_MAX);
-    side_boundary->GetComponent<Render>()->SetVisible(this->show_zone_borders);
+    {
+        std::lock_guard<std::mutex> lock(this->entity_commands_mutex);
+        this->applied_entity_commands.swap(this->entity_commands);
+    }
+
+    for (const EntityCommand &command : this->applied_entity_commands) {
+        if (command.type == EntityCommandType::Add) {
+            this->InsertEntity(command.entity);
+        } else if (command.type == EntityCommandType::Remove) {
+            this->EraseEntity(command.entity);
+        } else if (command.entity->IsInEngine()) {
+            std::lock_guard<std::mutex> lock(this->entities_mutex);
+            this->RemoveFromViews(command.entity);
+            this->AddToViews(command.entity);
+        }
+    }
 
-    this->AddEntity(side_boundary);
+    if (!this->applied_entity_commands.empty()) {
+        this->PublishEntitySnapshot();
+    }
+    this->applied_entity_commands.clear();
 }
 
-void Engine::RemoveEntity(Entity *entity) {
+// Retired entities and snapshots are destroyed once no network thread can still be reading them.
+// Entities removed during this frame are only retired here, so the engine loop also gets until the
+// next frame to drop them.
+void Engine::ReclaimRemovedEntities() {
+    ZoneScoped;
+
+    EpochManager &epoch_manager = EpochManager::GetInstance();
+    uint64_t safe_epoch = epoch_manager.GetSafeEpoch();
+    auto reclaim = [safe_epoch](auto &retired_list, auto dispose) {
+        size_t kept = 0;
+        for (auto &retired : retired_list) {
+            if (retired.first <= safe_epoch) {
+                dispose(retired.second);
+            } else {
+                retired_list[kept++] = retired;
+            }
+        }
+        retired_list.resize(kept);
+    };
+
     std::lock_guard<std::mutex> lock(this->entities_mutex);
-    auto iterator = std::find(entities.begin(), entities.end(), entity);
+    this->DropReclaimedDirtyTransforms(safe_epoch);
+    reclaim(this->retired_entities, [](Entity *entity) { delete entity; });
+    // Snapshots are refilled by later publishes, so their lists keep the capacity they grew to
+    reclaim(this->retired_snapshots,
+            [this](EntitySnapshot *snapshot) { this->free_snapshots.push_back(snapshot); });
+
+    if (!this->removed_entities.empty()) {
+        uint64_t epoch = epoch_manager.Advance();
+        for (Entity *entity : this->removed_entities) {
+            this->retired_entities.push_back({epoch, entity});
+        }
+        this->removed_entities.clear();
+    }
+}
 
-    if (iterator != entities.end()) {
-        entities.erase(iterator);
+// A network thread can move an entity right before it is removed, which leaves it queued in a dirty
+// set. Once the entity is reclaimed no thread can queue it again, so dropping it here is final.
+void Engine::DropReclaimedDirtyTransforms(uint64_t safe_epoch) {
+    std::vector<Entity *> &reclaimed = this->reclaimed_entities;
+    reclaimed.clear();
+    for (auto &retired : this->retired_entities) {
+        if (retired.first <= safe_epoch) {
+            reclaimed.push_back(retired.second);
+        }
+    }
+    if (reclaimed.empty()) {
+        return;
+    }
+    std::sort(reclaimed.begin(), reclaimed.end());
+
+    std::lock_guard<std::mutex> lock(this->dirty_transforms_mutex);
+    for (std::vector<Entity *> &transforms : this->dirty_transforms) {
+        transforms.erase(std::remove_if(transforms.begin(), transforms.end(),
+                                        [&reclaimed](Entity *entity) {
+                                            return std::binary_search(reclaimed.begin(),
+                                                                      reclaimed.end(), entity);
+                                        }),
+                         transforms.end());
     }
 }
 
-Entity *Engine::GetSpawnPoint(int index) {
+void Engine::PublishEntitySnapshot() {
     ZoneScoped;
 
-    std::vector<Entity *> spawn_points =
-        GetEntitiesByCategory(this->GetEntities(), EntityCategory::SpawnPoint);
+    std::lock_guard<std::mutex> lock(this->entities_mutex);
 
-    if (spawn_points.size() == 0) {
-        return nullptr;
+    EntitySnapshot *snapshot;
+    if (this->free_snapshots.empty()) {
+        snapshot = new EntitySnapshot();
+    } else {
+        snapshot = this->free_snapshots.back();
+        this->free_snapshots.pop_back();
+    }
+    snapshot->entities = this->entities;
+    snapshot->networked_entities = this->GetComponentView(ComponentMaskOf<Network>());
+    snapshot->entity_names.clear();
+    for (Entity *entity : this->entities) {
+        snapshot->entity_names.push_back({entity->GetNameId(), entity});
     }
+    std::sort(snapshot->entity_names.begin(), snapshot->entity_names.end());
+
+    EntitySnapshot *previous_snapshot = this->entity_snapshot.exchange(snapshot);
+    this->retired_snapshots.push_back({EpochManager::GetInstance().Advance(), previous_snapshot});
+}
+
+void Engine::DestroyEntities() {
+    this->ApplyEntityCommands();
 
-    if (index >= 0 && index < spawn_points.size()) {
-        return spawn_points[index];
+    std::lock_guard<std::mutex> lock(this->entities_mutex);
+    for (std::vector<Entity *> *entity_list : {&this->entities, &this->removed_entities}) {
+        for (Entity *entity : *entity_list) {
+            delete entity;
+        }
+        entity_list->clear();
+    }
+    for (auto &retired : this->retired_entities) {
+        delete retired.second;
+    }
+    this->retired_entities.clear();
+    for (auto &retired : this->retired_snapshots) {
+        delete retired.second;
     }
+    this->retired_snapshots.clear();
+    for (EntitySnapshot *snapshot : this->free_snapshots) {
+        delete snapshot;
+    }
+    this->free_snapshots.clear();
+    {
+        std::lock_guard<std::mutex> dirty_lock(this->dirty_transforms_mutex);
+        for (std::vector<Entity *> &transforms : this->dirty_transforms) {
+            transforms.clear();
+        }
+    }
+    this->contacts.Clear();
+    this->colliders.clear();
+    this->triggers.Clear();
+    this->trigger_subscribers.clear();
+    delete this->entity_snapshot.exchange(new EntitySnapshot());
+    {
+        std::lock_guard<std::mutex> players_lock(this->players_mutex);
+        this->players.clear();
+        this->local_player.store(nullptr);
+    }
+    this->component_views.clear();
+    for (std::vector<Entity *> &view : this->category_views) {
+        view.clear();
+    }
+    for (std::vector<Entity *> &view : this->tag_views) {
+        view.clear();
+    }
+}
 
-    int random_index = GetRandomInt(int(spawn_points.size() - 1));
-    return spawn_points[random_index];
+void Engine::RemoveEntity(EntityId entity_id) {
+    Entity *entity = this->GetEntity(entity_id);
+    if (entity) {
+        this->RemoveEntity(entity);
+    }
 }
 
-void Engine::AddSpawnPoint(Position position, Size size) {
-    size_t spawn_point_index =
-        GetEntitiesByCategory(this->GetEntities(), EntityCategory::SpawnPoint).size();
-    Entity *spawn_point =
-        new Entity("spawn_point_" + std::to_string(spawn_point_index), EntityCategory::SpawnPoint);
-    spawn_point->AddComponent<Transform>();
-    spawn_point->AddComponent<Render>();
+Entity *Engine::GetEntity(EntityId entity_id) {
+    return EntityDirectory::GetInstance().Resolve(entity_id);
+}
 
-    spawn_point->GetComponent<Transform>()->SetPosition(position);
-    spawn_point->GetComponent<Transform>()->SetSize(size);
-    spawn_point->GetComponent<Render>()->SetBorder(Border{true, this->spawn_point_color});
-    spawn_point->GetComponent<Render>()->SetDepth(INT_MAX);
-    spawn_point->GetComponent<Render>()->SetVisible(this->show_zone_borders);
+// Spawn points are looked up by their index, and players without one of their own spawn at a
+// random one
+bool Engine::GetSpawnPosition(int index, Position &position) {
+    ZoneScoped;
 
-    this->AddEntity(spawn_point);
+    const Trigger *spawn_point = this->triggers.Find(EntityCategory::SpawnPoint, index);
+    if (spawn_point == nullptr) {
+        int spawn_point_count = this->triggers.GetCount(EntityCategory::SpawnPoint);
+        if (spawn_point_count == 0) {
+            return false;
+        }
+        spawn_point = this->triggers.Find(EntityCategory::SpawnPoint,
+                                          GetRandomInt(spawn_point_count - 1));
+    }
+
+    position = spawn_point->position;
+    return true;
+}
+
+void Engine::AddSpawnPoint(Position position, Size size) {
+    this->triggers.Add(EntityCategory::SpawnPoint, position, size, false);
 }
 
 void Engine::AddDeathZone(Position position, Size size) {
-    size_t death_zone_index =
-        GetEntitiesByCategory(this->GetEntities(), EntityCategory::DeathZone).size();
-    Entity *death_zone =
-        new Entity("death_zone_" + std::to_string(death_zone_index), EntityCategory::DeathZone);
-    death_zone->AddComponent<Transform>();
-    death_zone->AddComponent<Render>();
+    this->triggers.Add(EntityCategory::DeathZone, position, size, false);
+}
 
-    death_zone->GetComponent<Transform>()->SetPosition(position);
-    death_zone->GetComponent<Transform>()->SetSize(size);
-    death_zone->GetComponent<Render>()->SetBorder(Border{true, this->death_zone_color});
-    death_zone->GetComponent<Render>()->SetDepth(INT_MAX);
-    death_zone->GetComponent<Render>()->SetVisible(this->show_zone_borders);
+// Entities can subscribe before they are added, and are unsubscribed when they are removed
+void Engine::SubscribeToTriggers(Entity *entity) {
+    if (entity != nullptr && std::find(this->trigger_subscribers.begin(),
+                                       this->trigger_subscribers.end(),
+                                       entity) == this->trigger_subscribers.end()) {
+        this->trigger_subscribers.push_back(entity);
+    }
+}
 
-    this->AddEntity(death_zone);
+void Engine::UnsubscribeFromTriggers(Entity *entity) {
+    this->trigger_subscribers.erase(
+        std::remove(this->trigger_subscribers.begin(), this->trigger_subscribers.end(), entity),
+        this->trigger_subscribers.end());
 }
 
+void Engine::SetTriggerCallback(TriggerCallback callback) { this->trigger_callback = callback; }
+
 void Engine::SetCallback(std::function<void(std::vector<Entity *> &)> callback) {
     this->callback = callback;
 }
@@ -1313,8 +1849,8 @@ void Engine::RegisterInputChord(int chord_id, std::unordered_set<SDL_Scancode> c
 void Engine::Update() {
     ZoneScoped;
 
-    std::vector<Entity *> entities = this->GetEntities();
-    this->callback(entities);
+    // Games get the live list itself, entities they add or remove are applied after the callback
+    this->callback(this->entities);
 }
 
 void Engine::GetTimeDelta() {
@@ -1330,146 +1866,617 @@ void Engine::GetTimeDelta() {
     this->engine_timeline->SetFrameTime(FrameTime{current, last, delta});
 }
 
+// Length of one fixed step in engine timeline units
+int64_t Engine::GetStepTime() { return 1'000'000'000 / this->tick_rate; }
+
+// Advances the simulation to the current engine time. Without a tick rate the simulation takes one
+// variable step per frame. With one, elapsed time is accumulated and consumed in fixed steps, so
+// the simulation runs at the same rate on every machine regardless of the frame rate, and whatever
+// is left over is used to interpolate transforms for rendering.
+void Engine::Simulate() {
+    ZoneScoped;
+
+    if (this->tick_rate <= 0) {
+        this->GetTimeDelta();
+        this->SavePreviousPoses();
+        this->SimulateStep();
+        this->interpolation_alpha = 1;
+        return;
+    }
+
+    int64_t step = this->GetStepTime();
+    int64_t current = this->engine_timeline->GetTime();
+    int64_t last = this->engine_timeline->GetFrameTime().last;
+
+    // Time beyond the substep cap is dropped, so a long stall does not make every following frame
+    // run even more steps to catch up
+    this->step_accumulator += std::max(current - last, static_cast<int64_t>(0));
+    this->step_accumulator = std::min(this->step_accumulator, step * this->max_substeps);
+    this->engine_timeline->SetFrameTime(FrameTime{current, current, step});
+
+    for (int substep = 0; this->step_accumulator >= step; substep++) {
+        // Events raised by the previous step, such as collisions, are handled before the next one
+        if (substep > 0) {
+            EventManager::GetInstance().ProcessEvents();
+            this->ApplyEntityCommands();
+        }
+
+        this->SavePreviousPoses();
+        this->SimulateStep();
+        this->step_accumulator -= step;
+    }
+
+    this->interpolation_alpha = static_cast<double>(this->step_accumulator) / step;
+}
+
+void Engine::SimulateStep() {
+    ZoneScoped;
+
+    this->ApplyEntityPhysicsAndUpdates();
+    this->TestCollision();
+    this->TestTriggers();
+    this->Update();
+    this->FlushDirtyTransforms();
+    this->ApplyEntityCommands();
+}
+
+// A transform that was not written since the last save still matches its saved pose, so only the
+// render set needs saving
+void Engine::SavePreviousPoses() {
+    ZoneScoped;
+
+    std::vector<Entity *> &moved = this->drained_transforms;
+    this->TakeDirtyTransforms(DirtySet::Render, moved);
+    for (Entity *entity : moved) {
+        entity->GetComponent<Transform>()->SavePreviousPose();
+    }
+}
+
+// Sleeps until the accumulator holds a full step, so a fixed rate server does not spin
+void Engine::WaitForNextTick() {
+    if (this->tick_rate <= 0) {
+        return;
+    }
+
+    int64_t remaining = this->GetStepTime() - this->step_accumulator;
+    if (remaining > 0) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(
+            static_cast<int64_t>(remaining * this->engine_timeline->GetTic())));
+    }
+}
+
+// Mirrors GetEntitiesByRole for a single entity, so the component arrays can be filtered in place
+bool Engine::IsSimulatedLocally(Entity *entity, Entity *player) {
+    if (!entity->IsInEngine()) {
+        return false;
+    }
+
+    NetworkRole role = this->network_info.role;
+    if (this->network_info.mode == NetworkMode::Single) {
+        return true;
+    }
+    if (role == NetworkRole::Client || role == NetworkRole::Peer) {
+        if (entity == player) {
+            return true;
+        }
+        if (entity->GetCategory() == EntityCategory::Controllable) {
+            return false;
+        }
+    }
+
+    Network *network = entity->GetComponent<Network>();
+    return network != nullptr && network->GetOwner() == role;
+}
+
 void Engine::ApplyEntityPhysicsAndUpdates() {
     ZoneScoped;
 
-    std::vector<Entity *> entities = GetEntitiesByRole(this->network_info, this->GetEntities());
+    Entity *player = this->GetLocalPlayer();
+
+    this->IntegratePhysics(player);
+
+    // Callbacks run in storage order on this thread unless they opted in to run in parallel
+    std::vector<Handler *> &parallel_handlers = this->parallel_handlers;
+    parallel_handlers.clear();
+    ComponentStorage<Handler>::GetInstance().ForEach([this, player, &parallel_handlers](
+                                                         Entity &entity, Handler &handler) {
+        if (this->IsSimulatedLocally(&entity, player)) {
+            if (handler.GetParallelUpdate()) {
+                parallel_handlers.push_back(&handler);
+            } else {
+                handler.Update();
+            }
+        }
+    });
+    JobSystem::GetInstance().ParallelFor(parallel_handlers.size(), HANDLER_CHUNK_SIZE,
+                                         [&parallel_handlers](size_t begin, size_t end) {
+                                             for (size_t i = begin; i < end; i++) {
+                                                 parallel_handlers[i]->Update();
+                                             }
+                                         });
+}
+
+// Integrates every locally simulated body in one batch. Positions are gathered into flat arrays,
+// advanced by a single vector kernel and moved straight back into the transforms. The bodies that
+// moved are marked dirty afterwards instead of each raising its own move event.
+void Engine::IntegratePhysics(Entity *player) {
+    ZoneScoped;
+
+    // Recorded moves drive every entity while a replay is running
+    if (Replay::GetInstance().GetIsReplaying()) {
+        return;
+    }
 
-    for (Entity *entity : entities) {
-        if (entity->GetComponent<Physics>() != nullptr) {
-            entity->GetComponent<Physics>()->Update();
+    IntegrationBatch &batch = this->integration_batch;
+    ClearIntegrationBatch(batch);
+    ComponentStorage<Physics>::GetInstance().ForEach([this, player, &batch](Entity &entity,
+                                                                             Physics &physics) {
+        Transform *transform = entity.GetComponent<Transform>();
+        if (transform != nullptr && !transform->IsSleeping() &&
+            this->IsSimulatedLocally(&entity, player)) {
+            AddToIntegrationBatch(batch, &entity, transform->GetPosition(), physics.GetVelocity(),
+                                  physics.GetAcceleration());
         }
-        if (entity->GetComponent<Handler>() != nullptr) {
-            entity->GetComponent<Handler>()->Update();
+    });
+
+    // Every body belongs to exactly one chunk, so chunks write their results back concurrently
+    float time = static_cast<float>(this->engine_timeline->GetFrameTime().delta) / 100'000'000.0f;
+    JobSystem::GetInstance().ParallelFor(
+        batch.entities.size(), INTEGRATION_CHUNK_SIZE, [&batch, time](size_t begin, size_t end) {
+            Integrator::GetInstance().Integrate(batch, begin, end, time);
+
+            for (size_t i = begin; i < end; i++) {
+                Entity *entity = batch.entities[i];
+                Physics *physics = entity->GetComponent<Physics>();
+                Velocity velocity = physics->GetVelocity();
+                if (batch.velocity_x[i] != velocity.x || batch.velocity_y[i] != velocity.y) {
+                    physics->SetVelocity(Velocity{batch.velocity_x[i], batch.velocity_y[i]});
+                }
+
+                Transform *transform = entity->GetComponent<Transform>();
+                Position position = transform->GetPosition();
+                if (batch.position_x[i] != position.x || batch.position_y[i] != position.y) {
+                    Position new_position = Position{batch.position_x[i], batch.position_y[i]};
+                    batch.moved[i] = transform->MoveUnmarked(new_position);
+
+                    Collision *collision = entity->GetComponent<Collision>();
+                    if (collision != nullptr && collision->GetContinuous()) {
+                        collision->SetSweep(position, new_position);
+                    }
+                }
+            }
+        });
+
+    // Marking takes the dirty set lock, so it is done here instead of from every chunk
+    for (size_t i = 0; i < batch.entities.size(); i++) {
+        if (batch.moved[i]) {
+            batch.entities[i]->GetComponent<Transform>()->MarkMoved();
         }
     }
 }
 
+void Engine::AddDirtyTransform(Entity *entity, DirtyMask mask) {
+    std::lock_guard<std::mutex> lock(this->dirty_transforms_mutex);
+    for (size_t set = 0; set < DIRTY_SET_COUNT; set++) {
+        if ((mask & DirtyMaskOf(DirtySet(set))) != 0) {
+            this->dirty_transforms[set].push_back(entity);
+        }
+    }
+}
+
+// The set is swapped out and its flags are cleared before any pose is read, so a write that lands
+// while the set is being consumed queues the entity again instead of being lost
+void Engine::TakeDirtyTransforms(DirtySet set, std::vector<Entity *> &transforms) {
+    transforms.clear();
+    {
+        std::lock_guard<std::mutex> lock(this->dirty_transforms_mutex);
+        transforms.swap(this->dirty_transforms[size_t(set)]);
+    }
+    for (Entity *entity : transforms) {
+        entity->GetComponent<Transform>()->ClearDirty(set);
+    }
+}
+
+// Sends the bodies moved through the fast path this step. Calling their network components directly
+// replaces a send update event per body, which every network component had to filter.
+void Engine::FlushDirtyTransforms() {
+    ZoneScoped;
+
+    std::vector<Entity *> &moved = this->drained_transforms;
+    this->TakeDirtyTransforms(DirtySet::Network, moved);
+    for (Entity *entity : moved) {
+        Network *network = entity->GetComponent<Network>();
+        if (network != nullptr && entity->IsInEngine()) {
+            network->SendUpdate();
+        }
+    }
+}
+
+// Collider order changes from step to step, so contacts are kept with the lower entity index first
+static bool IsContactSwapped(const Collider &collider_1, const Collider &collider_2) {
+    return collider_2.entity->GetId().index < collider_1.entity->GetId().index;
+}
+
+// Sweeps a pair that does not overlap at the end of the step. When both bodies are swept their
+// relative motion is tested from where both started, otherwise the swept body is tested against
+// where the other one ended up.
+static bool GetSweepTimeOfImpact(const Collider &collider_1, const Collider &collider_2,
+                                 float &time_of_impact) {
+    const Collider &moving = collider_1.swept ? collider_1 : collider_2;
+    const Collider &target = collider_1.swept ? collider_2 : collider_1;
+
+    Position displacement = moving.displacement;
+    SDL_Rect target_rect = target.rect;
+    if (target.swept) {
+        displacement.x -= target.displacement.x;
+        displacement.y -= target.displacement.y;
+        target_rect = target.start_rect;
+    }
+
+    return GetTimeOfImpact(moving.start_rect, displacement, target_rect, time_of_impact);
+}
+
+// Tests one candidate pair. Colliders are only read here, so chunks of pairs can be tested
+// concurrently, each into its own buffer.
+static void TestPair(const std::vector<Collider> &colliders, std::pair<uint32_t, uint32_t> pair,
+                     bool overlaps, std::vector<PairContact> &buffer) {
+    const Collider &collider_1 = colliders[pair.first];
+    const Collider &collider_2 = colliders[pair.second];
+    bool swapped = IsContactSwapped(collider_1, collider_2);
+    uint32_t first = swapped ? pair.second : pair.first;
+    uint32_t second = swapped ? pair.first : pair.second;
+
+    if (overlaps) {
+        ContactManifold manifold =
+            GetContactManifold(colliders[first].rect, colliders[second].rect);
+        buffer.push_back(PairContact{first, second, PairResult::Touching, manifold, 1});
+        return;
+    }
+
+    float time_of_impact;
+    if ((collider_1.swept || collider_2.swept) &&
+        GetSweepTimeOfImpact(collider_1, collider_2, time_of_impact)) {
+        buffer.push_back(PairContact{pair.first, pair.second, PairResult::Swept, ContactManifold{},
+                                     time_of_impact});
+    }
+}
+
 void Engine::TestCollision() {
     ZoneScoped;
 
-    std::vector<Entity *> entities = this->GetEntities();
-
-    for (int i = 0; i < entities.size() - 1; i++) {
-        for (int j = i + 1; j < entities.size(); j++) {
-            SDL_Rect entity_1 = {static_cast<int>(std::round(
-                                     entities[i]->GetComponent<Transform>()->GetPosition().x)),
-                                 static_cast<int>(std::round(
-                                     entities[i]->GetComponent<Transform>()->GetPosition().y)),
-                                 entities[i]->GetComponent<Transform>()->GetSize().width,
-                                 entities[i]->GetComponent<Transform>()->GetSize().height};
-            SDL_Rect entity_2 = {static_cast<int>(std::round(
-                                     entities[j]->GetComponent<Transform>()->GetPosition().x)),
-                                 static_cast<int>(std::round(
-                                     entities[j]->GetComponent<Transform>()->GetPosition().y)),
-                                 entities[j]->GetComponent<Transform>()->GetSize().width,
-                                 entities[j]->GetComponent<Transform>()->GetSize().height};
-
-            bool entity_1_zone = IsZoneCategory(entities[i]->GetCategory());
-            bool entity_2_zone = IsZoneCategory(entities[j]->GetCategory());
-            bool entity_1_player = entities[i] == GetClientPlayer(this->network_info.id, entities);
-            bool entity_2_player = entities[j] == GetClientPlayer(this->network_info.id, entities);
-            bool entity_1_controllable = entities[i]->GetCategory() == EntityCategory::Controllable;
-            bool entity_2_controllable = entities[j]->GetCategory() == EntityCategory::Controllable;
-
-            if ((entity_1_zone && entity_2_zone) || (entity_1_zone && !entity_2_player) ||
-                (entity_2_zone && !entity_1_player) ||
-                (entity_1_controllable && entity_2_controllable)) {
+    Entity *player = this->GetLocalPlayer();
+
+    // Gather the bounds of every live entity in one pass over the dense transform array, so the
+    // pairwise test below never has to look a component up. The same pass advances every body's
+    // sleep counter.
+    std::vector<Collider> &colliders = this->colliders;
+    colliders.clear();
+    ComponentStorage<Transform>::GetInstance().ForEach([this, &colliders, player](
+                                                           Entity &entity, Transform &transform) {
+        if (!entity.IsInEngine()) {
+            return;
+        }
+
+        Physics *physics = entity.GetComponent<Physics>();
+        transform.UpdateSleep(physics != nullptr && physics->HasMotion());
+
+        Position position = transform.GetPosition();
+        Size size = transform.GetSize();
+        SDL_Rect rect = {static_cast<int>(std::round(position.x)),
+                         static_cast<int>(std::round(position.y)), size.width, size.height};
+
+        Collision *collision = entity.GetComponent<Collision>();
+        int layer = collision != nullptr ? collision->GetLayer() : DEFAULT_COLLISION_LAYER;
+        CollisionMask mask = collision != nullptr ? collision->GetMask() : ALL_COLLISION_LAYERS;
+        CollisionFilter filter = {CollisionMaskOf(layer),
+                                  mask & this->collision_matrix[layer],
+                                  collision != nullptr,
+                                  IsZoneCategory(entity.GetCategory()),
+                                  &entity == player,
+                                  entity.GetCategory() == EntityCategory::Controllable};
+
+        Position start = position;
+        bool swept = collision != nullptr && collision->GetContinuous() &&
+                     collision->TakeSweep(position, start);
+        SDL_Rect start_rect = {static_cast<int>(std::round(start.x)),
+                               static_cast<int>(std::round(start.y)), size.width, size.height};
+
+        colliders.push_back(Collider{&entity, entity.GetId(), rect, filter,
+                                     transform.IsSleeping(), swept, start_rect, position,
+                                     Position{position.x - start.x, position.y - start.y}, 1,
+                                     nullptr});
+    });
+
+    // Two sleeping bodies cannot have started touching, so the broadphase only pairs sleeping
+    // bodies with awake ones, and the contact cache keeps the contacts between sleeping bodies
+    size_t awake_count = std::stable_partition(colliders.begin(), colliders.end(),
+                                               [](const Collider &collider) {
+                                                   return !collider.sleeping;
+                                               }) -
+                         colliders.begin();
+
+    // Only colliders whose filters accept each other and whose boxes overlap are tested. Swept
+    // colliders are found by the box covering their whole sweep, so they still meet everything
+    // they could have passed through.
+    std::vector<std::pair<uint32_t, uint32_t>> &pairs = this->collision_pairs;
+    this->broadphase.FindPairs(colliders, awake_count, pairs);
+
+    // The overlap kernel tests the boxes of several pairs at once and leaves one hit bit per pair
+    AabbBatch &boxes = this->collider_boxes;
+    ClearAabbBatch(boxes);
+    for (const Collider &collider : colliders) {
+        AddToAabbBatch(boxes, collider.rect);
+    }
+    std::vector<uint64_t> &hits = this->overlap_hits;
+    hits.resize(GetHitMaskWords(pairs.size()));
+
+    // Chunks of pairs are tested concurrently, each into its own buffer. The buffers are merged in
+    // chunk order, so contacts are resolved and raised in the same order a serial loop would.
+    size_t chunk_count = (pairs.size() + NARROWPHASE_CHUNK_SIZE - 1) / NARROWPHASE_CHUNK_SIZE;
+    std::vector<std::vector<PairContact>> &buffers = this->contact_buffers;
+    if (buffers.size() < chunk_count) {
+        buffers.resize(chunk_count);
+    }
+    for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+        buffers[chunk].clear();
+    }
+    JobSystem::GetInstance().ParallelFor(
+        pairs.size(), NARROWPHASE_CHUNK_SIZE,
+        [&colliders, &pairs, &boxes, &hits, &buffers](size_t begin, size_t end) {
+            AabbOverlap::GetInstance().TestPairs(boxes, pairs.data(), begin, end, hits.data());
+
+            std::vector<PairContact> &buffer = buffers[begin / NARROWPHASE_CHUNK_SIZE];
+            for (size_t i = begin; i < end; i++) {
+                TestPair(colliders, pairs[i], HasHit(hits.data(), i), buffer);
+            }
+        });
+
+    bool raise_stay = EventManager::GetInstance().HasHandlers(EventType::CollisionStay);
+    this->contacts.BeginStep();
+
+    // Every swept body keeps the earliest body it hits. These are found before any contact is
+    // resolved, since resolution moves the bodies the sweeps started from.
+    for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+        for (const PairContact &contact : buffers[chunk]) {
+            if (contact.result != PairResult::Swept) {
+                continue;
+            }
+
+            Collider &collider_1 = colliders[contact.collider_1];
+            Collider &collider_2 = colliders[contact.collider_2];
+            for (Collider *collider : {&collider_1, &collider_2}) {
+                if (collider->swept && contact.time_of_impact < collider->time_of_impact) {
+                    collider->time_of_impact = contact.time_of_impact;
+                    collider->first_hit = collider == &collider_1 ? &collider_2 : &collider_1;
+                }
+            }
+        }
+    }
+
+    // Swept bodies are moved back from where the integrator left them to where they first touched
+    // what they hit, so the collision is resolved at the contact instead of after the body has
+    // already passed through
+    for (Collider &collider : colliders) {
+        if (collider.first_hit == nullptr) {
+            continue;
+        }
+
+        Position contact = collider.position;
+        contact.x -= (1 - collider.time_of_impact) * collider.displacement.x;
+        contact.y -= (1 - collider.time_of_impact) * collider.displacement.y;
+        collider.entity->GetComponent<Transform>()->Move(contact);
+        collider.rect.x = static_cast<int>(std::round(contact.x));
+        collider.rect.y = static_cast<int>(std::round(contact.y));
+    }
+
+    for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+        for (const PairContact &contact : buffers[chunk]) {
+            if (contact.result != PairResult::Touching) {
                 continue;
             }
 
-            if (SDL_HasIntersection(&entity_1, &entity_2)) {
-                EventManager::GetInstance().RaiseCollisionEvent(
-                    CollisionEvent{entities[i], entities[j]});
+            Collider &collider_1 = colliders[contact.collider_1];
+            Collider &collider_2 = colliders[contact.collider_2];
+
+            // A body that was moved back only keeps the end of step contacts it still has where
+            // it was moved to, so it never touches what lies past the body it hit first
+            ContactManifold manifold = contact.manifold;
+            if (collider_1.first_hit != nullptr || collider_2.first_hit != nullptr) {
+                if (!SDL_HasIntersection(&collider_1.rect, &collider_2.rect)) {
+                    continue;
+                }
+                manifold = GetContactManifold(collider_1.rect, collider_2.rect);
+            }
+
+            // A contact with an awake body wakes a sleeping one
+            for (Collider *collider : {&collider_1, &collider_2}) {
+                if (collider->sleeping) {
+                    collider->entity->GetComponent<Transform>()->Wake();
+                }
             }
+            this->AddContact(collider_1, collider_2, manifold, raise_stay);
+        }
+    }
+
+    // Two swept bodies that hit each other first share one contact
+    for (const Collider &collider : colliders) {
+        const Collider *other = collider.first_hit;
+        if (other == nullptr || (other->first_hit == &collider && other < &collider)) {
+            continue;
         }
+
+        bool swapped = IsContactSwapped(collider, *other);
+        const Collider &first = swapped ? *other : collider;
+        const Collider &second = swapped ? collider : *other;
+        this->AddContact(first, second, GetContactManifold(first.rect, second.rect), raise_stay);
+    }
+
+    this->contacts.TakeExits(this->contact_exits);
+    for (const CollisionEvent &exit : this->contact_exits) {
+        EventManager::GetInstance().RaiseCollisionEvent(exit);
     }
 }
 
-void Engine::HandleSideBoundaries(Entity *side_boundary) {
-    ZoneScoped;
+// Shares the manifold of a touching pair, ordered the way the contact cache keeps it, between the
+// resolution of both bodies and the collision event. Handlers only hear about the pair when it
+// starts touching, unless they subscribed to stay events.
+void Engine::AddContact(const Collider &first, const Collider &second,
+                        const ContactManifold &manifold, bool raise_stay) {
+    EntityId first_id = first.entity->GetId();
+    EntityId second_id = second.entity->GetId();
+    ContactPhase phase = this->contacts.Touch(first_id, second_id, manifold);
 
-    Entity *player = GetClientPlayer(this->network_info.id, this->GetEntities());
-    if (player == nullptr) {
+    // Recorded moves already contain the resolved positions while a replay is running
+    if (Replay::GetInstance().GetIsReplaying()) {
         return;
     }
 
-    this->SetSideBoundaryVelocities(Velocity{0, 0});
-    this->camera->GetComponent<Physics>()->SetVelocity({0, 0});
+    Collision *first_collision = first.entity->GetComponent<Collision>();
+    if (first_collision != nullptr) {
+        first_collision->HandlePairwiseCollision(second.entity, manifold);
+    }
+    Collision *second_collision = second.entity->GetComponent<Collision>();
+    if (second_collision != nullptr) {
+        second_collision->HandlePairwiseCollision(first.entity, FlipManifold(manifold));
+    }
+
+    CollisionEvent collision_event = CollisionEvent{first_id, second_id, phase, manifold};
+    if (phase == ContactPhase::Enter) {
+        EventManager::GetInstance().RaiseCollisionEvent(collision_event);
+    } else if (raise_stay) {
+        EventManager::GetInstance().RaiseCollisionStayEvent(collision_event);
+    }
+}
 
-    int obj_x = static_cast<int>(std::round(player->GetComponent<Transform>()->GetPosition().x));
-    int obj_y = static_cast<int>(std::round(player->GetComponent<Transform>()->GetPosition().y));
-    int col_x =
-        static_cast<int>(std::round(side_boundary->GetComponent<Transform>()->GetPosition().x));
-    int col_y =
-        static_cast<int>(std::round(side_boundary->GetComponent<Transform>()->GetPosition().y));
+// Triggers are only tested against the local player and the entities that subscribed to them. On
+// top of the callbacks, the local player dies in death zones and scrolls the camera at side
+// boundaries for every step it stays in them.
+void Engine::TestTriggers() {
+    ZoneScoped;
 
-    int obj_width = player->GetComponent<Transform>()->GetSize().width;
-    int obj_height = player->GetComponent<Transform>()->GetSize().height;
-    int col_width = side_boundary->GetComponent<Transform>()->GetSize().width;
-    int col_height = side_boundary->GetComponent<Transform>()->GetSize().height;
+    Entity *player = this->GetLocalPlayer();
+    std::vector<std::pair<EntityId, SDL_Rect>> &entities = this->trigger_entities;
+    entities.clear();
+    auto add_entity = [&entities](Entity *entity) {
+        Transform *transform = entity->GetComponent<Transform>();
+        if (transform == nullptr) {
+            return;
+        }
 
-    SDL_Rect rect_1 = {obj_x, obj_y, obj_width, obj_height};
-    SDL_Rect rect_2 = {col_x, col_y, col_width, col_height};
-    Overlap overlap = GetOverlap(rect_1, rect_2);
-    float vel_x = player->GetComponent<Physics>()->GetVelocity().x;
-    float vel_y = player->GetComponent<Physics>()->GetVelocity().y;
+        Position position = transform->GetPosition();
+        Size size = transform->GetSize();
+        entities.emplace_back(entity->GetId(),
+                              SDL_Rect{static_cast<int>(std::round(position.x)),
+                                       static_cast<int>(std::round(position.y)), size.width,
+                                       size.height});
+    };
 
-    if (overlap == Overlap::Left || overlap == Overlap::Right) {
-        this->camera->GetComponent<Physics>()->SetVelocity({vel_x, 0});
-        this->SetSideBoundaryVelocities({vel_x, 0});
+    if (player != nullptr && player->IsInEngine()) {
+        add_entity(player);
     }
-    if (overlap == Overlap::Top || overlap == Overlap::Bottom) {
-        this->camera->GetComponent<Physics>()->SetVelocity({0, vel_y});
-        this->SetSideBoundaryVelocities({0, vel_y});
+    for (Entity *entity : this->trigger_subscribers) {
+        if (entity != player && entity->IsInEngine()) {
+            add_entity(entity);
+        }
     }
 
-    this->camera->GetComponent<Physics>()->Update();
-    for (Entity *entity : this->GetEntities()) {
-        if (entity->GetCategory() == EntityCategory::SideBoundary) {
-            entity->GetComponent<Physics>()->Update();
+    this->triggers.Test(entities, this->camera->GetComponent<Transform>()->GetPosition(),
+                        this->trigger_contacts);
+
+    // Recorded moves already hold what the player ran into while a replay is running
+    bool replaying = Replay::GetInstance().GetIsReplaying();
+    for (const TriggerContact &contact : this->trigger_contacts) {
+        Entity *entity = this->GetEntity(contact.entity);
+        if (entity == nullptr) {
+            continue;
+        }
+
+        const Trigger &trigger = this->triggers.GetTriggers()[contact.trigger];
+        if (entity == player && contact.phase != ContactPhase::Exit && !replaying) {
+            this->HandleTrigger(trigger, player, contact.manifold.side);
+        }
+        if (contact.phase != ContactPhase::Stay && this->trigger_callback) {
+            this->trigger_callback(entity, trigger, contact.phase);
         }
     }
 }
 
-void Engine::RespawnPlayer() {
+// Zones have always only affected players that can collide
+void Engine::HandleTrigger(const Trigger &trigger, Entity *player, Overlap overlap) {
+    if (player->GetComponent<Collision>() == nullptr) {
+        return;
+    }
+
+    if (trigger.category == EntityCategory::DeathZone) {
+        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{player->GetId()});
+    } else if (trigger.category == EntityCategory::SideBoundary) {
+        this->HandleSideBoundary(trigger, player, overlap);
+    }
+}
+
+// The camera scrolls with the player along the axis of the side the player touches, and the player
+// is held at the boundary, so it stays on screen. The boundary moves along with the camera. The
+// side comes from the manifold the trigger test found.
+void Engine::HandleSideBoundary(const Trigger &side_boundary, Entity *player, Overlap overlap) {
     ZoneScoped;
 
-    Entity *player = GetClientPlayer(this->network_info.id, this->GetEntities());
-    if (player == nullptr) {
+    Transform *transform = player->GetComponent<Transform>();
+    Physics *physics = player->GetComponent<Physics>();
+    if (physics == nullptr) {
         return;
     }
 
-    this->ResetSideBoundaries();
-    EventManager::GetInstance().RaiseMoveEvent(MoveEvent{this->camera.get(), Position{0, 0}});
+    Transform *camera_transform = this->camera->GetComponent<Transform>();
+    Physics *camera_physics = this->camera->GetComponent<Physics>();
+    Position position = transform->GetPosition();
+    Size size = transform->GetSize();
+    SDL_Rect player_box = {static_cast<int>(std::round(position.x)),
+                           static_cast<int>(std::round(position.y)), size.width, size.height};
 
-    Position respawn_point =
-        this->GetSpawnPoint(this->network_info.id - 1)->GetComponent<Transform>()->GetPosition();
-    EventManager::GetInstance().RaiseMoveEvent(MoveEvent{player, respawn_point});
-}
+    Velocity velocity = physics->GetVelocity();
+    camera_physics->SetVelocity({0, 0});
+    if (overlap == Overlap::Left || overlap == Overlap::Right) {
+        camera_physics->SetVelocity({velocity.x, 0});
+    }
+    if (overlap == Overlap::Top || overlap == Overlap::Bottom) {
+        camera_physics->SetVelocity({0, velocity.y});
+    }
+    camera_physics->Update();
 
-void Engine::ResetSideBoundaries() {
-    ZoneScoped;
+    Network *network = player->GetComponent<Network>();
+    if ((network != nullptr && network->GetOwner() != this->network_info.role) ||
+        player->GetComponent<Collision>()->GetAvoidTransform()) {
+        return;
+    }
 
-    std::vector<Entity *> side_boundaries =
-        GetEntitiesByCategory(this->GetEntities(), EntityCategory::SideBoundary);
-    for (Entity *side_boundary : side_boundaries) {
-        // The screen position of the side boundary will always be equal to its original position
-        Position original_position =
-            GetScreenPosition(side_boundary->GetComponent<Transform>()->GetPosition(),
-                              this->camera->GetComponent<Transform>()->GetPosition());
-        side_boundary->GetComponent<Physics>()->SetVelocity(Velocity{0, 0});
-        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{side_boundary, original_position});
+    SDL_Rect box = this->triggers.GetBox(side_boundary, camera_transform->GetPosition());
+    Position held_position = Position{float(player_box.x), float(player_box.y)};
+    if (overlap == Overlap::Left) {
+        held_position.x = float(box.x - player_box.w);
+    } else if (overlap == Overlap::Right) {
+        held_position.x = float(box.x + box.w);
+    } else if (overlap == Overlap::Top) {
+        held_position.y = float(box.y - player_box.h);
+    } else if (overlap == Overlap::Bottom) {
+        held_position.y = float(box.y + box.h);
     }
+    transform->Move(held_position);
 }
 
-void Engine::SetSideBoundaryVelocities(Velocity velocity) {
+// Side boundaries follow the camera, so moving the camera back puts them back as well
+void Engine::RespawnPlayer() {
     ZoneScoped;
 
-    std::vector<Entity *> side_boundaries =
-        GetEntitiesByCategory(this->GetEntities(), EntityCategory::SideBoundary);
-    for (Entity *side_boundary : side_boundaries) {
-        side_boundary->GetComponent<Physics>()->SetVelocity(velocity);
+    Entity *player = this->GetLocalPlayer();
+    if (player == nullptr) {
+        return;
+    }
+
+    EventManager::GetInstance().RaiseMoveEvent(MoveEvent{this->camera->GetId(), Position{0, 0}});
+
+    Position respawn_point;
+    if (this->GetSpawnPosition(this->network_info.id - 1, respawn_point)) {
+        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{player->GetId(), respawn_point});
     }
 }
 
@@ -1493,23 +2500,25 @@ void Engine::RenderScene() {
 
     this->RenderBackground();
 
-    auto entities = this->GetEntities();
-    auto render_entities = std::vector<Entity *>();
-    for (Entity *entity : entities) {
-        if (entity->GetComponent<Render>() != nullptr) {
-            render_entities.push_back(entity);
+    std::vector<std::pair<int, Render *>> &render_queue = this->render_queue;
+    render_queue.clear();
+    ComponentStorage<Render>::GetInstance().ForEach([&render_queue](Entity &entity,
+                                                                     Render &render) {
+        if (entity.IsInEngine()) {
+            render_queue.emplace_back(render.GetDepth(), &render);
         }
-    }
-    std::sort(render_entities.begin(), render_entities.end(),
-              [](Entity *entity_1, Entity *entity_2) {
-                  return entity_1->GetComponent<Render>()->GetDepth() <
-                         entity_2->GetComponent<Render>()->GetDepth();
+    });
+    std::sort(render_queue.begin(), render_queue.end(),
+              [](const std::pair<int, Render *> &render_1,
+                 const std::pair<int, Render *> &render_2) {
+                  return render_1.first < render_2.first;
               });
 
-    for (Entity *entity : render_entities) {
-        entity->GetComponent<Render>()->Update();
+    for (auto &render : render_queue) {
+        render.second->Update();
     }
 
+    this->RenderTriggers();
     this->RenderBorder();
 
 #ifdef PROFILE
@@ -1531,6 +2540,37 @@ void Engine::RenderBackground() {
     SDL_RenderClear(app->renderer);
 }
 
+// Trigger outlines are drawn over every entity, the way zone entities were drawn at the top depth
+void Engine::RenderTriggers() {
+    ZoneScoped;
+
+    if (!this->show_zone_borders) {
+        return;
+    }
+
+    Position camera_position = this->camera->GetComponent<Transform>()
+                                   ->GetInterpolatedPose(this->interpolation_alpha)
+                                   .position;
+    SDL_SetRenderDrawBlendMode(app->renderer, SDL_BLENDMODE_BLEND);
+    for (const Trigger &trigger : this->triggers.GetTriggers()) {
+        Position position = trigger.follows_camera
+                                ? trigger.position
+                                : GetScreenPosition(trigger.position, camera_position);
+        SDL_Rect rectangle = {static_cast<int>(std::round(position.x)),
+                              static_cast<int>(std::round(position.y)), trigger.size.width,
+                              trigger.size.height};
+
+        Color color = this->death_zone_color;
+        if (trigger.category == EntityCategory::SideBoundary) {
+            color = this->side_boundary_color;
+        } else if (trigger.category == EntityCategory::SpawnPoint) {
+            color = this->spawn_point_color;
+        }
+        SDL_SetRenderDrawColor(app->renderer, color.red, color.green, color.blue, color.alpha);
+        SDL_RenderDrawRect(app->renderer, &rectangle);
+    }
+}
+
 void Engine::RenderBorder() {
     ZoneScoped;
 
@@ -1591,45 +2631,27 @@ void Engine::CaptureTracyFrameImage() {
     SDL_FreeSurface(scaled_surface);
 }
 
-void Engine::SetEntityTransforms() {
-    std::vector<Entity *> all_entities = this->GetEntities();
-    all_entities.push_back(this->camera.get());
-
-    for (const auto &entity : all_entities) {
-        this->entity_transforms[entity] = {entity->GetComponent<Transform>()->GetPosition(),
-                                           entity->GetComponent<Transform>()->GetAngle()};
-    }
-}
-
+// Records the transforms written during the frame. The replay set is drained even while nothing is
+// being recorded, so a recording only starts with the writes made after it.
 void Engine::RecordEvents() {
+    std::vector<Entity *> &moved = this->drained_transforms;
+    this->TakeDirtyTransforms(DirtySet::Replay, moved);
     if (!Replay::GetInstance().GetIsRecording()) {
         return;
     }
 
-    std::vector<Entity *> all_entities = this->GetEntities();
-    all_entities.push_back(this->camera.get());
-
-    for (const auto &entity : all_entities) {
-        Position prev_pos = Position{};
-        double prev_angle = 0;
-        auto iterator = this->entity_transforms.find(entity);
-        if (iterator != this->entity_transforms.end()) {
-            prev_pos = iterator->second.first;
-            prev_angle = iterator->second.second;
-        }
-        Position curr_pos = entity->GetComponent<Transform>()->GetPosition();
-        double curr_angle = entity->GetComponent<Transform>()->GetAngle();
-        if (curr_pos.x == prev_pos.x && curr_pos.y == prev_pos.y && curr_angle == prev_angle) {
+    for (Entity *entity : moved) {
+        if (!entity->IsInEngine() && entity != this->camera.get()) {
             continue;
         }
 
-        Event move_event = Event(EventType::Move, MoveEvent{entity, curr_pos, curr_angle});
+        Pose pose = entity->GetComponent<Transform>()->GetPose();
+        Event move_event =
+            Event(EventType::Move, MoveEvent{entity->GetId(), pose.position, pose.angle});
         move_event.SetDelay(-1);
         move_event.SetPriority(Priority::High);
         Replay::GetInstance().RecordEvent(move_event);
     }
-
-    this->SetEntityTransforms();
 }
 
 void Engine::HandleScaling() {
@@ -1652,6 +2674,8 @@ void Engine::HandleScaling() {
 void Engine::Shutdown() {
     ZoneScoped;
 
+    this->DestroyEntities();
+
     this->join_socket.close();
     this->server_broadcast_socket.close();
     this->client_update_socket.close();
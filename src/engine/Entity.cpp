@@ -1,12 +1,128 @@
 #include "Entity.hpp"
+#include "Engine.hpp"
+#include "EntityDirectory.hpp"
+#include "NameTable.hpp"
+#include "Pool.hpp"
 #include "Types.hpp"
 
 Entity::Entity(std::string name, EntityCategory category) {
     this->name = name;
+    this->name_id.store(NameTable::GetInstance().Intern(name));
     this->category = category;
+    this->id = EntityDirectory::GetInstance().Register(this);
+    this->engine_index.store(-1);
+    this->tags.store(0);
+    this->indexed_tags = 0;
+    this->view_slots.fill(-1);
+
+    for (auto &component : this->components) {
+        component.store(nullptr);
+    }
+}
+
+Entity::~Entity() {
+    EntityDirectory::GetInstance().Release(this->id);
+    NameTable::GetInstance().Release(this->name_id.load());
+
+    std::lock_guard<std::mutex> lock(this->components_mutex);
+    for (size_t type_id = 0; type_id < MAX_COMPONENTS; type_id++) {
+        this->ReleaseComponent(type_id);
+    }
+}
+
+void *Entity::operator new(size_t size) {
+    if (size != sizeof(Entity)) {
+        return ::operator new(size);
+    }
+    return Pool<Entity>::GetInstance().Allocate();
+}
+
+void Entity::operator delete(void *pointer, size_t size) {
+    if (pointer == nullptr) {
+        return;
+    }
+    if (size != sizeof(Entity)) {
+        ::operator delete(pointer);
+        return;
+    }
+    Pool<Entity>::GetInstance().Deallocate(pointer);
+}
+
+void Entity::ReleaseComponent(size_t type_id) {
+    if (this->components[type_id].exchange(nullptr) == nullptr) {
+        return;
+    }
+    ComponentEntry entry = this->component_entries[type_id];
+    entry.release(entry.slot);
+}
+
+// The engine's query views are keyed on the components and tags an entity has, so entities that are
+// already in the engine have to be re-matched when either changes
+void Entity::RefreshViews() {
+    if (this->IsInEngine()) {
+        Engine::GetInstance().RefreshEntity(this);
+    }
 }
 
 std::string Entity::GetName() { return this->name; }
+uint32_t Entity::GetNameId() { return this->name_id.load(); }
 EntityCategory Entity::GetCategory() { return this->category; }
+EntityId Entity::GetId() { return this->id; }
+int Entity::GetEngineIndex() { return this->engine_index.load(); }
+bool Entity::IsInEngine() { return this->engine_index.load() >= 0; }
+TagMask Entity::GetTags() { return this->tags.load(); }
+TagMask Entity::GetIndexedTags() { return this->indexed_tags; }
+int Entity::GetViewSlot(size_t view) { return this->view_slots[view]; }
+
+bool Entity::HasTag(int tag) {
+    if (tag < 0 || tag >= int(MAX_TAGS)) {
+        return false;
+    }
+    return (this->tags.load() & (TagMask(1) << tag)) != 0;
+}
+
+ComponentMask Entity::GetComponentMask() {
+    ComponentMask mask = 0;
+    for (size_t type_id = 0; type_id < MAX_COMPONENTS; type_id++) {
+        if (this->components[type_id].load(std::memory_order_acquire) != nullptr) {
+            mask |= ComponentMask(1) << type_id;
+        }
+    }
+    return mask;
+}
+
+void Entity::SetName(std::string name) {
+    this->name = name;
+    uint32_t old_name_id = this->name_id.exchange(NameTable::GetInstance().Intern(name));
+    if (this->IsInEngine()) {
+        Engine::GetInstance().ReindexEntityName(this);
+    }
+    NameTable::GetInstance().Release(old_name_id);
+}
+
+void Entity::SetId(EntityId entity_id) { this->id = entity_id; }
+void Entity::SetEngineIndex(int engine_index) { this->engine_index.store(engine_index); }
+void Entity::SetIndexedTags(TagMask indexed_tags) { this->indexed_tags = indexed_tags; }
+void Entity::SetViewSlot(size_t view, int slot) { this->view_slots[view] = slot; }
+
+void Entity::AddTag(int tag) {
+    if (tag < 0 || tag >= int(MAX_TAGS)) {
+        return;
+    }
+
+    TagMask bit = TagMask(1) << tag;
+    if ((this->tags.fetch_or(bit) & bit) == 0) {
+        this->RefreshViews();
+    }
+}
+
+void Entity::RemoveTag(int tag) {
+    if (tag < 0 || tag >= int(MAX_TAGS)) {
+        return;
+    }
 
-void Entity::SetName(std::string name) { this->name = name; }
\ No newline at end of file
+    TagMask bit = TagMask(1) << tag;
+    if ((this->tags.fetch_and(~bit) & bit) != 0) {
+        this->RefreshViews();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "EntityDirectory.hpp"
+#include "Types.hpp"
+
+EntityDirectory::~EntityDirectory() {
+    for (auto &chunk : this->chunks) {
+        delete chunk.load();
+    }
+}
+
+EntityDirectory::Slot *EntityDirectory::GetSlot(uint32_t index) {
+    if (index / CHUNK_SIZE >= MAX_CHUNKS) {
+        return nullptr;
+    }
+
+    Chunk *chunk = this->chunks[index / CHUNK_SIZE].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+        return nullptr;
+    }
+
+    return &chunk->slots[index % CHUNK_SIZE];
+}
+
+EntityId EntityDirectory::Register(Entity *entity) {
+    std::lock_guard<std::mutex> lock(this->directory_mutex);
+
+    uint32_t index;
+    if (!this->free_slots.empty()) {
+        index = this->free_slots.back();
+        this->free_slots.pop_back();
+    } else {
+        index = this->slot_count++;
+        if (this->chunks[index / CHUNK_SIZE].load(std::memory_order_relaxed) == nullptr) {
+            this->chunks[index / CHUNK_SIZE].store(new Chunk(), std::memory_order_release);
+        }
+    }
+
+    Slot *slot = this->GetSlot(index);
+    slot->entity.store(entity, std::memory_order_release);
+
+    return EntityId{index, slot->generation.load(std::memory_order_relaxed)};
+}
+
+// Releasing an already stale handle is a no-op, so an entity can be released when it leaves the
+// engine and again when it is destroyed
+void EntityDirectory::Release(EntityId entity_id) {
+    std::lock_guard<std::mutex> lock(this->directory_mutex);
+
+    Slot *slot = this->GetSlot(entity_id.index);
+    if (slot == nullptr ||
+        slot->generation.load(std::memory_order_relaxed) != entity_id.generation) {
+        return;
+    }
+
+    uint32_t generation = entity_id.generation + 1;
+    if (generation == 0) {
+        generation = 1;
+    }
+
+    slot->generation.store(generation, std::memory_order_release);
+    slot->entity.store(nullptr, std::memory_order_release);
+    this->free_slots.push_back(entity_id.index);
+}
+
+Entity *EntityDirectory::Resolve(EntityId entity_id) {
+    Slot *slot = this->GetSlot(entity_id.index);
+    if (slot == nullptr) {
+        return nullptr;
+    }
+
+    Entity *entity = slot->entity.load(std::memory_order_acquire);
+    if (slot->generation.load(std::memory_order_acquire) != entity_id.generation) {
+        return nullptr;
+    }
+
+    return entity;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "EpochManager.hpp"
+#include "Types.hpp"
+#include "Utils.hpp"
+
+// Every thread claims a reader slot the first time it reads and hands it back when it exits
+struct ReaderSlot {
+    int slot = EpochManager::GetInstance().AcquireReaderSlot();
+    int depth = 0;
+
+    ~ReaderSlot() { EpochManager::GetInstance().ReleaseReaderSlot(this->slot); }
+};
+
+static thread_local ReaderSlot reader_slot;
+
+int EpochManager::AcquireReaderSlot() {
+    for (size_t i = 0; i < MAX_READERS; i++) {
+        bool expected = false;
+        if (this->reader_slots_used[i].compare_exchange_strong(expected, true)) {
+            return int(i);
+        }
+    }
+
+    Log(LogLevel::Warn, "Out of epoch reader slots, reclamation waits on shared readers");
+    return -1;
+}
+
+void EpochManager::ReleaseReaderSlot(int slot) {
+    if (slot >= 0) {
+        this->reader_epochs[slot].store(0);
+        this->reader_slots_used[slot].store(false);
+    }
+}
+
+// Publishing the pinned epoch is a single store, so readers never wait on the writer
+void EpochManager::Enter(int slot) {
+    if (slot >= 0) {
+        this->reader_epochs[slot].store(this->global_epoch.load());
+    } else {
+        this->overflow_readers.fetch_add(1);
+    }
+}
+
+void EpochManager::Exit(int slot) {
+    if (slot >= 0) {
+        this->reader_epochs[slot].store(0);
+    } else {
+        this->overflow_readers.fetch_sub(1);
+    }
+}
+
+// Returns the epoch to tag data that was just unpublished with. Readers that pin an epoch after
+// this call can no longer reach that data.
+uint64_t EpochManager::Advance() { return this->global_epoch.fetch_add(1); }
+
+uint64_t EpochManager::GetSafeEpoch() {
+    if (this->overflow_readers.load() > 0) {
+        return 0;
+    }
+
+    uint64_t safe_epoch = this->global_epoch.load() - 1;
+    for (const std::atomic<uint64_t> &reader_epoch : this->reader_epochs) {
+        uint64_t pinned = reader_epoch.load();
+        if (pinned != 0 && pinned - 1 < safe_epoch) {
+            safe_epoch = pinned - 1;
+        }
+    }
+    return safe_epoch;
+}
+
+EpochGuard::EpochGuard() {
+    if (reader_slot.depth++ == 0) {
+        EpochManager::GetInstance().Enter(reader_slot.slot);
+    }
+}
+
+EpochGuard::~EpochGuard() {
+    if (--reader_slot.depth == 0) {
+        EpochManager::GetInstance().Exit(reader_slot.slot);
+    }
+}
\ No newline at end of file
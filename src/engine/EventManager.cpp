@@ -55,6 +55,10 @@ void EventManager::HandleReplayedEvent(Event event) {
 }
 
 void EventManager::HandleEvent(Event event) {
+    if (this->HasStaleEntity(event)) {
+        return;
+    }
+
     auto handlers = this->GetHandlers();
 
     auto iterator = handlers.find(event.type);
@@ -66,6 +70,47 @@ void EventManager::HandleEvent(Event event) {
     }
 }
 
+// Queued and recorded events can outlive the entities they refer to, such events are dropped
+bool EventManager::HasStaleEntity(const Event &event) {
+    Engine &engine = Engine::GetInstance();
+
+    switch (event.type) {
+    case EventType::Move: {
+        const MoveEvent *move_event = std::get_if<MoveEvent>(&(event.data));
+        return move_event && engine.GetEntity(move_event->entity) == nullptr;
+    }
+    case EventType::SendUpdate: {
+        const SendUpdateEvent *send_update_event = std::get_if<SendUpdateEvent>(&(event.data));
+        return send_update_event && engine.GetEntity(send_update_event->entity) == nullptr;
+    }
+    case EventType::Collision:
+    case EventType::CollisionStay: {
+        const CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
+        if (collision_event == nullptr) {
+            return false;
+        }
+
+        bool removed_1 = engine.GetEntity(collision_event->collider_1) == nullptr;
+        bool removed_2 = engine.GetEntity(collision_event->collider_2) == nullptr;
+        // The entity that is still there hears that its partner is gone
+        if (collision_event->phase == ContactPhase::Exit) {
+            return removed_1 && removed_2;
+        }
+        return removed_1 || removed_2;
+    }
+    case EventType::Spawn: {
+        const SpawnEvent *spawn_event = std::get_if<SpawnEvent>(&(event.data));
+        return spawn_event && engine.GetEntity(spawn_event->entity) == nullptr;
+    }
+    case EventType::Death: {
+        const DeathEvent *death_event = std::get_if<DeathEvent>(&(event.data));
+        return death_event && engine.GetEntity(death_event->entity) == nullptr;
+    }
+    default:
+        return false;
+    }
+}
+
 void EventManager::ProcessEvents() {
 #ifdef PROFILE
     this->ProfileEventQueue();
@@ -119,23 +164,26 @@ void EventManager::ProfileEventQueue() {
         case EventType::Move: {
             zone_text += "Move";
             const MoveEvent *move_event = std::get_if<MoveEvent>(&(event.data));
-            if (move_event) {
-                zone_text += "_" + std::string(move_event->entity->GetName());
+            Entity *entity =
+                move_event ? Engine::GetInstance().GetEntity(move_event->entity) : nullptr;
+            if (entity) {
+                zone_text += "_" + entity->GetName();
             }
 
             break;
         }
 
-        case EventType::Collision: {
+        case EventType::Collision:
+        case EventType::CollisionStay: {
             zone_text += "Collision";
             const CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
             if (collision_event) {
-                zone_text += "_" + GetEntityByName((collision_event->collider_1->GetName()),
-                                                   Engine::GetInstance().GetEntities())
-                                       ->GetName();
-                zone_text += "_" + GetEntityByName((collision_event->collider_2->GetName()),
-                                                   Engine::GetInstance().GetEntities())
-                                       ->GetName();
+                Entity *collider_1 = Engine::GetInstance().GetEntity(collision_event->collider_1);
+                Entity *collider_2 = Engine::GetInstance().GetEntity(collision_event->collider_2);
+                if (collider_1 && collider_2) {
+                    zone_text += "_" + collider_1->GetName();
+                    zone_text += "_" + collider_2->GetName();
+                }
             }
 
             break;
@@ -144,10 +192,10 @@ void EventManager::ProfileEventQueue() {
         case EventType::Spawn: {
             zone_text += "Spawn";
             const SpawnEvent *spawn_event = std::get_if<SpawnEvent>(&(event.data));
-            if (spawn_event) {
-                zone_text += "_" + GetEntityByName((spawn_event->entity->GetName()),
-                                                   Engine::GetInstance().GetEntities())
-                                       ->GetName();
+            Entity *entity =
+                spawn_event ? Engine::GetInstance().GetEntity(spawn_event->entity) : nullptr;
+            if (entity) {
+                zone_text += "_" + entity->GetName();
             }
 
             break;
@@ -156,10 +204,10 @@ void EventManager::ProfileEventQueue() {
         case EventType::Death: {
             zone_text += "Death";
             const DeathEvent *death_event = std::get_if<DeathEvent>(&(event.data));
-            if (death_event) {
-                zone_text += "_" + GetEntityByName((death_event->entity->GetName()),
-                                                   Engine::GetInstance().GetEntities())
-                                       ->GetName();
+            Entity *entity =
+                death_event ? Engine::GetInstance().GetEntity(death_event->entity) : nullptr;
+            if (entity) {
+                zone_text += "_" + entity->GetName();
             }
 
             break;
@@ -193,6 +241,14 @@ void EventManager::RaiseCollisionEvent(CollisionEvent event) {
     this->Raise(collision_event);
 }
 
+void EventManager::RaiseCollisionStayEvent(CollisionEvent event) {
+    Event collision_event = Event(EventType::CollisionStay, event);
+    collision_event.SetDelay(0);
+    collision_event.SetPriority(Priority::Medium);
+
+    this->Raise(collision_event);
+}
+
 void EventManager::RaiseDeathEvent(DeathEvent event) {
     if (this->IsDeathOrSpawnInQueue()) {
         return;
@@ -214,10 +270,16 @@ void EventManager::RaiseSpawnEvent(SpawnEvent event) {
 }
 
 void EventManager::RaiseMoveEvent(MoveEvent event, bool ignore_change) {
+    Entity *entity = Engine::GetInstance().GetEntity(event.entity);
+    if (entity == nullptr) {
+        return;
+    }
+
     Position new_pos = event.position;
-    Position cur_pos = event.entity->GetComponent<Transform>()->GetPosition();
+    Pose cur_pose = entity->GetComponent<Transform>()->GetPose();
+    Position cur_pos = cur_pose.position;
     double new_angle = event.angle;
-    double cur_angle = event.entity->GetComponent<Transform>()->GetAngle();
+    double cur_angle = cur_pose.angle;
 
     if (!ignore_change) {
         if ((new_pos.x == cur_pos.x) && (new_pos.y == cur_pos.y) && (new_angle == cur_angle)) {
@@ -320,6 +382,13 @@ std::unordered_map<EventType, std::unordered_set<EventHandler *>> EventManager::
     return this->handlers;
 }
 
+// Lets a producer skip building events nobody listens to
+bool EventManager::HasHandlers(EventType event_type) {
+    std::lock_guard<std::mutex> lock(this->handlers_mutex);
+    auto iterator = this->handlers.find(event_type);
+    return iterator != this->handlers.end() && !iterator->second.empty();
+}
+
 void EventManager::PushEventQueue(Event event) {
     std::lock_guard<std::mutex> lock(this->event_queue_mutex);
     this->event_queue.push(event);
@@ -6,10 +6,17 @@ Handler::Handler(Entity *entity) {
     this->entity = entity;
     this->update_callback = [](Entity &) {};
     this->event_callback = [](Entity &, Event &) {};
+    this->parallel_update = false;
+    this->collision_stay = false;
 
     EventManager::GetInstance().Register({EventType::Input, EventType::Collision}, this);
 }
 
+Handler::~Handler() {
+    EventManager::GetInstance().Deregister(
+        {EventType::Input, EventType::Collision, EventType::CollisionStay}, this);
+}
+
 std::function<void(Entity &)> Handler::GetUpdateCallback() { return this->update_callback; }
 
 void Handler::SetUpdateCallback(std::function<void(Entity &)> update_callback) {
@@ -21,6 +28,24 @@ void Handler::SetEventCallback(std::function<void(Entity &, Event &)> event_call
     this->event_callback = event_callback;
 }
 
+bool Handler::GetParallelUpdate() { return this->parallel_update; }
+void Handler::SetParallelUpdate(bool parallel_update) { this->parallel_update = parallel_update; }
+
+bool Handler::GetCollisionStay() { return this->collision_stay; }
+
+void Handler::SetCollisionStay(bool collision_stay) {
+    if (collision_stay == this->collision_stay) {
+        return;
+    }
+
+    this->collision_stay = collision_stay;
+    if (collision_stay) {
+        EventManager::GetInstance().Register({EventType::CollisionStay}, this);
+    } else {
+        EventManager::GetInstance().Deregister({EventType::CollisionStay}, this);
+    }
+}
+
 void Handler::Update() { this->update_callback(*this->entity); }
 
 void Handler::OnEvent(Event event) { this->event_callback(*this->entity, event); }
\ No newline at end of file
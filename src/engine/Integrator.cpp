@@ -0,0 +1,155 @@
+#include "Integrator.hpp"
+#include "Types.hpp"
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define INTEGRATOR_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define INTEGRATOR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define INTEGRATOR_TARGET_AVX2
+#endif
+
+// Every kernel applies the same constant acceleration step as Physics::Move, with the square of
+// the step computed once per batch instead of calling pow for every body
+static void IntegrateScalar(IntegrationBatch &batch, size_t begin, size_t end, float time) {
+    const float HALF = 0.5;
+    float time_squared = time * time;
+
+    float *position_x = batch.position_x.data();
+    float *position_y = batch.position_y.data();
+    float *velocity_x = batch.velocity_x.data();
+    float *velocity_y = batch.velocity_y.data();
+    const float *acceleration_x = batch.acceleration_x.data();
+    const float *acceleration_y = batch.acceleration_y.data();
+
+    for (size_t i = begin; i < end; i++) {
+        position_x[i] =
+            position_x[i] + (velocity_x[i] * time) + (HALF * acceleration_x[i] * time_squared);
+        position_y[i] =
+            position_y[i] + (velocity_y[i] * time) + (HALF * acceleration_y[i] * time_squared);
+        velocity_x[i] += acceleration_x[i] * time;
+        velocity_y[i] += acceleration_y[i] * time;
+    }
+}
+
+#ifdef INTEGRATOR_X86
+static void IntegrateSSE(IntegrationBatch &batch, size_t begin, size_t end, float time) {
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 step = _mm_set1_ps(time);
+    const __m128 step_squared = _mm_set1_ps(time * time);
+
+    float *fields[2][3] = {
+        {batch.position_x.data(), batch.velocity_x.data(), batch.acceleration_x.data()},
+        {batch.position_y.data(), batch.velocity_y.data(), batch.acceleration_y.data()}};
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        for (auto &field : fields) {
+            __m128 position = _mm_loadu_ps(field[0] + i);
+            __m128 velocity = _mm_loadu_ps(field[1] + i);
+            __m128 acceleration = _mm_loadu_ps(field[2] + i);
+
+            position = _mm_add_ps(_mm_add_ps(position, _mm_mul_ps(velocity, step)),
+                                  _mm_mul_ps(_mm_mul_ps(half, acceleration), step_squared));
+            velocity = _mm_add_ps(velocity, _mm_mul_ps(acceleration, step));
+
+            _mm_storeu_ps(field[0] + i, position);
+            _mm_storeu_ps(field[1] + i, velocity);
+        }
+    }
+
+    IntegrateScalar(batch, i, end, time);
+}
+
+INTEGRATOR_TARGET_AVX2
+static void IntegrateAVX2(IntegrationBatch &batch, size_t begin, size_t end, float time) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 step = _mm256_set1_ps(time);
+    const __m256 step_squared = _mm256_set1_ps(time * time);
+
+    float *fields[2][3] = {
+        {batch.position_x.data(), batch.velocity_x.data(), batch.acceleration_x.data()},
+        {batch.position_y.data(), batch.velocity_y.data(), batch.acceleration_y.data()}};
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        for (auto &field : fields) {
+            __m256 position = _mm256_loadu_ps(field[0] + i);
+            __m256 velocity = _mm256_loadu_ps(field[1] + i);
+            __m256 acceleration = _mm256_loadu_ps(field[2] + i);
+
+            position =
+                _mm256_add_ps(_mm256_add_ps(position, _mm256_mul_ps(velocity, step)),
+                              _mm256_mul_ps(_mm256_mul_ps(half, acceleration), step_squared));
+            velocity = _mm256_add_ps(velocity, _mm256_mul_ps(acceleration, step));
+
+            _mm256_storeu_ps(field[0] + i, position);
+            _mm256_storeu_ps(field[1] + i, velocity);
+        }
+    }
+
+    IntegrateSSE(batch, i, end, time);
+}
+
+static bool SupportsAVX2() {
+#if defined(_MSC_VER)
+    int registers[4];
+    __cpuid(registers, 1);
+    bool os_saves_ymm = (registers[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(registers, 7, 0);
+    return os_saves_ymm && (registers[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+Integrator::Integrator() {
+    this->kernel = IntegrateScalar;
+    this->kernel_name = "scalar";
+
+#ifdef INTEGRATOR_X86
+    this->kernel = IntegrateSSE;
+    this->kernel_name = "SSE";
+    if (SupportsAVX2()) {
+        this->kernel = IntegrateAVX2;
+        this->kernel_name = "AVX2";
+    }
+#endif
+}
+
+const char *Integrator::GetKernelName() { return this->kernel_name; }
+
+void Integrator::Integrate(IntegrationBatch &batch, size_t begin, size_t end, float time) {
+    this->kernel(batch, begin, end, time);
+}
+
+void ClearIntegrationBatch(IntegrationBatch &batch) {
+    batch.entities.clear();
+    batch.position_x.clear();
+    batch.position_y.clear();
+    batch.velocity_x.clear();
+    batch.velocity_y.clear();
+    batch.acceleration_x.clear();
+    batch.acceleration_y.clear();
+    batch.moved.clear();
+}
+
+void AddToIntegrationBatch(IntegrationBatch &batch, Entity *entity, Position position,
+                           Velocity velocity, Acceleration acceleration) {
+    batch.entities.push_back(entity);
+    batch.position_x.push_back(position.x);
+    batch.position_y.push_back(position.y);
+    batch.velocity_x.push_back(velocity.x);
+    batch.velocity_y.push_back(velocity.y);
+    batch.acceleration_x.push_back(acceleration.x);
+    batch.acceleration_y.push_back(acceleration.y);
+    batch.moved.push_back(0);
+}
\ No newline at end of file
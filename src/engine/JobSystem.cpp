@@ -0,0 +1,130 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <string>
+
+#include "Profile.hpp"
+PROFILED;
+
+// Queue the current thread pushes to and pops from, workers set it to their own queue
+static thread_local size_t own_queue = 0;
+
+JobSystem::JobSystem() {
+    size_t hardware_threads = std::thread::hardware_concurrency();
+    size_t worker_count = hardware_threads > 1 ? hardware_threads - 1 : 0;
+
+    for (size_t i = 0; i <= worker_count; i++) {
+        this->queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 1; i <= worker_count; i++) {
+        this->workers.emplace_back([this, i]() { this->WorkerThread(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(this->wake_mutex);
+        this->stopping.store(true);
+    }
+    this->wake.notify_all();
+
+    for (std::thread &worker : this->workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+size_t JobSystem::GetWorkerCount() { return this->workers.size(); }
+
+void JobSystem::WorkerThread(size_t queue_index) {
+    std::string thread_name = "JobWorker_" + std::to_string(queue_index);
+    TracySetThreadName(thread_name.c_str());
+    own_queue = queue_index;
+
+    while (true) {
+        Job job;
+        if (this->TryGetJob(queue_index, job)) {
+            this->RunJob(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(this->wake_mutex);
+        this->wake.wait(lock, [this]() {
+            return this->stopping.load() || this->pending_jobs.load() > 0;
+        });
+        if (this->stopping.load()) {
+            return;
+        }
+    }
+}
+
+bool JobSystem::TryGetJob(size_t queue_index, Job &job) {
+    {
+        WorkerQueue &queue = *this->queues[queue_index];
+        std::lock_guard<std::mutex> lock(queue.queue_mutex);
+        if (!queue.jobs.empty()) {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+            this->pending_jobs.fetch_sub(1);
+            return true;
+        }
+    }
+
+    for (size_t offset = 1; offset < this->queues.size(); offset++) {
+        WorkerQueue &victim = *this->queues[(queue_index + offset) % this->queues.size()];
+        std::lock_guard<std::mutex> lock(victim.queue_mutex);
+        if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            this->pending_jobs.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::RunJob(const Job &job) {
+    ZoneScoped;
+
+    (*job.function)(job.begin, job.end);
+    job.remaining->fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::ParallelFor(size_t count, size_t chunk_size,
+                            const std::function<void(size_t, size_t)> &function) {
+    if (count == 0) {
+        return;
+    }
+
+    chunk_size = std::max(chunk_size, size_t(1));
+    size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+    if (this->workers.empty() || chunk_count == 1) {
+        function(0, count);
+        return;
+    }
+
+    // Chunks are dealt round robin so every worker starts on its own deque before it has to steal
+    std::atomic<size_t> remaining{chunk_count};
+    for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+        size_t begin = chunk * chunk_size;
+        size_t end = std::min(begin + chunk_size, count);
+        WorkerQueue &queue = *this->queues[(own_queue + chunk) % this->queues.size()];
+        std::lock_guard<std::mutex> lock(queue.queue_mutex);
+        queue.jobs.push_back(Job{&function, begin, end, &remaining});
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->wake_mutex);
+        this->pending_jobs.fetch_add(chunk_count);
+    }
+    this->wake.notify_all();
+
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        Job job;
+        if (this->TryGetJob(own_queue, job)) {
+            this->RunJob(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
\ No newline at end of file
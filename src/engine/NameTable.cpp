@@ -0,0 +1,55 @@
+#include "NameTable.hpp"
+
+// Every Intern takes a reference on the name that has to be given back through Release
+uint32_t NameTable::Intern(const std::string &name) {
+    std::lock_guard<std::mutex> lock(this->names_mutex);
+
+    auto iterator = this->name_ids.find(name);
+    if (iterator != this->name_ids.end()) {
+        this->entries[iterator->second].references++;
+        return iterator->second;
+    }
+
+    uint32_t name_id;
+    if (!this->free_ids.empty()) {
+        name_id = this->free_ids.back();
+        this->free_ids.pop_back();
+        this->entries[name_id].name = name;
+        this->entries[name_id].references = 1;
+    } else {
+        name_id = uint32_t(this->entries.size());
+        this->entries.push_back(NameEntry{name, 1});
+    }
+    this->name_ids.emplace(name, name_id);
+    return name_id;
+}
+
+void NameTable::Release(uint32_t name_id) {
+    std::lock_guard<std::mutex> lock(this->names_mutex);
+
+    if (name_id >= this->entries.size() || this->entries[name_id].references == 0) {
+        return;
+    }
+
+    NameEntry &entry = this->entries[name_id];
+    if (--entry.references > 0) {
+        return;
+    }
+    this->name_ids.erase(entry.name);
+    entry.name.clear();
+    this->free_ids.push_back(name_id);
+}
+
+// Unlike Intern, never adds the name, so looking up names received over the network cannot grow
+// the table
+bool NameTable::Find(const std::string &name, uint32_t &name_id) {
+    std::lock_guard<std::mutex> lock(this->names_mutex);
+
+    auto iterator = this->name_ids.find(name);
+    if (iterator == this->name_ids.end()) {
+        return false;
+    }
+
+    name_id = iterator->second;
+    return true;
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Network.hpp"
 #include "Engine.hpp"
 #include "Entity.hpp"
+#include "EpochManager.hpp"
 #include "Event.hpp"
 #include "EventManager.hpp"
 #include "Replay.hpp"
@@ -16,6 +17,8 @@ Network::Network(Entity *entity) {
     EventManager::GetInstance().Register({EventType::SendUpdate}, this);
 }
 
+Network::~Network() { EventManager::GetInstance().Deregister({EventType::SendUpdate}, this); }
+
 bool Network::GetActive() { return this->active.load(); }
 std::string Network::GetPlayerAddress() { return this->player_address; }
 NetworkRole Network::GetOwner() { return this->owner; }
@@ -28,40 +31,46 @@ void Network::SetOwner(NetworkRole owner) { this->owner = owner; }
 
 void Network::Update() {}
 
+// Sends the entity's current state to the other side. Called for send update events and directly
+// by the engine for the locally simulated entities that moved during the step.
+void Network::SendUpdate() {
+    if (Replay::GetInstance().GetIsReplaying()) {
+        return;
+    }
+
+    NetworkRole engine_role = Engine::GetInstance().GetNetworkInfo().role;
+
+    switch (engine_role) {
+    case NetworkRole::Server:
+        Engine::GetInstance().CSServerBroadcastUpdates(this->entity);
+        break;
+    case NetworkRole::Client: {
+        EpochGuard guard;
+        if (this->entity == Engine::GetInstance().GetLocalPlayer()) {
+            Engine::GetInstance().CSClientSendUpdate();
+        }
+        break;
+    }
+    case NetworkRole::Host:
+    case NetworkRole::Peer:
+        if (this->GetOwner() == engine_role) {
+            Engine::GetInstance().P2PBroadcastUpdates(this->entity);
+        }
+        break;
+    default:
+        Log(LogLevel::Error, "Network mode/role not supported");
+        break;
+    }
+}
+
 void Network::OnEvent(Event event) {
     EventType event_type = event.type;
 
     switch (event_type) {
     case EventType::SendUpdate: {
-        if (Replay::GetInstance().GetIsReplaying()) {
-            return;
-        }
-
         SendUpdateEvent *send_update_event = std::get_if<SendUpdateEvent>(&(event.data));
-        if (send_update_event && send_update_event->entity == this->entity) {
-            NetworkRole engine_role = Engine::GetInstance().GetNetworkInfo().role;
-
-            switch (engine_role) {
-            case NetworkRole::Server:
-                Engine::GetInstance().CSServerBroadcastUpdates(this->entity);
-                break;
-            case NetworkRole::Client:
-                if (this->entity == GetClientPlayer(Engine::GetInstance().GetNetworkInfo().id,
-                                                    Engine::GetInstance().GetEntities())) {
-                    Engine::GetInstance().CSClientSendUpdate();
-                }
-                break;
-            case NetworkRole::Host:
-            case NetworkRole::Peer:
-                if (this->entity->GetComponent<Network>() &&
-                    this->entity->GetComponent<Network>()->GetOwner() == engine_role) {
-                    Engine::GetInstance().P2PBroadcastUpdates(this->entity);
-                }
-                break;
-            default:
-                Log(LogLevel::Error, "Network mode/role not supported");
-                break;
-            }
+        if (send_update_event && send_update_event->entity == this->entity->GetId()) {
+            this->SendUpdate();
         }
         break;
     }
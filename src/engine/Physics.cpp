@@ -1,11 +1,9 @@
 #include "Physics.hpp"
 #include "Entity.hpp"
-#include "EventManager.hpp"
 #include "Replay.hpp"
 #include "Timeline.hpp"
 #include "Transform.hpp"
 #include "Types.hpp"
-#include <cmath>
 #include <cstdint>
 #include <cstring>
 
@@ -23,16 +21,35 @@ void Physics::SetEngineTimeline(std::shared_ptr<Timeline> engine_timeline) {
 Velocity Physics::GetVelocity() { return this->velocity; }
 Acceleration Physics::GetAcceleration() { return this->acceleration; }
 
+bool Physics::HasMotion() {
+    return this->velocity.x != 0 || this->velocity.y != 0 || this->acceleration.x != 0 ||
+           this->acceleration.y != 0;
+}
+
+// Setting motion wakes the body, but callbacks that keep a resting body at zero every frame do not
 void Physics::SetVelocity(Velocity velocity) {
     // maybe add a reference to the entity to deal with this
     if (this->entity->GetCategory() != EntityCategory::Stationary) {
+        bool wake = velocity.x != 0 || velocity.y != 0 || velocity.x != this->velocity.x ||
+                    velocity.y != this->velocity.y;
         this->velocity = velocity;
+        Transform *transform = this->entity->GetComponent<Transform>();
+        if (wake && transform != nullptr) {
+            transform->Wake();
+        }
     }
 }
 void Physics::SetAcceleration(Acceleration acceleration) {
     // maybe add a reference to the entity to deal with this
     if (this->entity->GetCategory() != EntityCategory::Stationary) {
+        bool wake = acceleration.x != 0 || acceleration.y != 0 ||
+                    acceleration.x != this->acceleration.x ||
+                    acceleration.y != this->acceleration.y;
         this->acceleration = acceleration;
+        Transform *transform = this->entity->GetComponent<Transform>();
+        if (wake && transform != nullptr) {
+            transform->Wake();
+        }
     }
 }
 
@@ -41,16 +58,15 @@ void Physics::Move() {
 
     const float HALF = 0.5;
     float time = static_cast<float>(delta) / 100'000'000.0f;
+    float time_squared = time * time;
     Position curr_position = this->entity->GetComponent<Transform>()->GetPosition();
-    float new_pos_x = curr_position.x + (this->velocity.x * time) +
-                      (HALF * this->acceleration.x * float(pow(time, 2)));
-    float new_pos_y = curr_position.y + (this->velocity.y * time) +
-                      (HALF * this->acceleration.y * float(pow(time, 2)));
+    float new_pos_x =
+        curr_position.x + (this->velocity.x * time) + (HALF * this->acceleration.x * time_squared);
+    float new_pos_y =
+        curr_position.y + (this->velocity.y * time) + (HALF * this->acceleration.y * time_squared);
 
     if (!Replay::GetInstance().GetIsReplaying()) {
-        EventManager::GetInstance().RaiseMoveEvent(
-            MoveEvent{this->entity, Position{new_pos_x, new_pos_y},
-                      this->entity->GetComponent<Transform>()->GetAngle()});
+        this->entity->GetComponent<Transform>()->Move(Position{new_pos_x, new_pos_y});
 
         this->velocity.x += (this->acceleration.x * time);
         this->velocity.y += (this->acceleration.y * time);
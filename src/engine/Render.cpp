@@ -1,4 +1,5 @@
 #include "Render.hpp"
+#include "Engine.hpp"
 #include "Entity.hpp"
 #include "Transform.hpp"
 #include "Types.hpp"
@@ -15,7 +16,7 @@ Render::Render(Entity *entity) {
     this->color = Color{0, 0, 0, 255};
     this->border = Border{false, Color{0, 0, 0, 255}};
     this->depth = 0;
-    this->camera = std::make_shared<Entity>("camera", EntityCategory::Camera);
+    this->camera = nullptr;
 }
 
 std::string Render::GetTexturePath() { return this->texture_path; }
@@ -46,14 +47,20 @@ void Render::RenderEntity() {
         return;
     }
 
-    Position position = GetScreenPosition(this->entity->GetComponent<Transform>()->GetPosition(),
-                                          this->camera->GetComponent<Transform>()->GetPosition());
+    double alpha = Engine::GetInstance().GetInterpolationAlpha();
+    Position camera_position = Position{0, 0};
+    if (this->camera) {
+        camera_position =
+            this->camera->GetComponent<Transform>()->GetInterpolatedPose(alpha).position;
+    }
+    Pose pose = this->entity->GetComponent<Transform>()->GetInterpolatedPose(alpha);
+    Position position = GetScreenPosition(pose.position, camera_position);
 
     int pos_x = static_cast<int>(std::round(position.x));
     int pos_y = static_cast<int>(std::round(position.y));
     int width = this->entity->GetComponent<Transform>()->GetSize().width;
     int height = this->entity->GetComponent<Transform>()->GetSize().height;
-    double angle = this->entity->GetComponent<Transform>()->GetAngle();
+    double angle = pose.angle;
     SDL_Point anchor = this->entity->GetComponent<Transform>()->GetAnchor();
     SDL_Point *anchor_ptr = (anchor.x == 0 && anchor.y == 0) ? nullptr : &anchor;
     int fill_r = this->color.red;
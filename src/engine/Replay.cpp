@@ -14,8 +14,10 @@ Replay::Replay() {
     this->replay_key = SDL_SCANCODE_R;
 
     this->recorded_events = std::vector<Event>();
-    this->start_record_transforms = std::vector<std::pair<Entity *, std::pair<Position, double>>>();
-    this->start_replay_transforms = std::vector<std::pair<Entity *, std::pair<Position, double>>>();
+    this->start_record_transforms =
+        std::vector<std::pair<EntityId, std::pair<Position, double>>>();
+    this->start_replay_transforms =
+        std::vector<std::pair<EntityId, std::pair<Position, double>>>();
 
     EventManager::GetInstance().Register({EventType::Input, EventType::StartRecord,
                                           EventType::StopRecord, EventType::StartReplay,
@@ -49,25 +51,23 @@ std::vector<Event> Replay::GetRecordedEvents() {
 }
 
 void Replay::SetStartTransforms(
-    std::vector<std::pair<Entity *, std::pair<Position, double>>> &start_transforms) {
+    std::vector<std::pair<EntityId, std::pair<Position, double>>> &start_transforms) {
     start_transforms.clear();
-    for (const auto &entity : Engine::GetInstance().GetEntities()) {
-        start_transforms.push_back({entity,
-                                    {entity->GetComponent<Transform>()->GetPosition(),
-                                     entity->GetComponent<Transform>()->GetAngle()}});
+    for (const auto &entity : Engine::GetInstance().GetLiveEntities()) {
+        Pose pose = entity->GetComponent<Transform>()->GetPose();
+        start_transforms.push_back({entity->GetId(), {pose.position, pose.angle}});
     }
-    start_transforms.push_back({this->camera.get(),
-                                {this->camera->GetComponent<Transform>()->GetPosition(),
-                                 this->camera->GetComponent<Transform>()->GetAngle()}});
+    Pose camera_pose = this->camera->GetComponent<Transform>()->GetPose();
+    start_transforms.push_back({this->camera->GetId(), {camera_pose.position, camera_pose.angle}});
 }
 
 void Replay::ApplyStartTransforms(
-    std::vector<std::pair<Entity *, std::pair<Position, double>>> &start_transforms) {
+    std::vector<std::pair<EntityId, std::pair<Position, double>>> &start_transforms) {
     for (const auto &entity_transform : start_transforms) {
-        Entity *entity = entity_transform.first;
+        EntityId entity_id = entity_transform.first;
         Position position = entity_transform.second.first;
         double angle = entity_transform.second.second;
-        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{entity, position, angle});
+        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{entity_id, position, angle});
     }
     start_transforms.clear();
 }
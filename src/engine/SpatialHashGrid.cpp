@@ -0,0 +1,182 @@
+#include "SpatialHashGrid.hpp"
+#include "AabbOverlap.hpp"
+#include "Types.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+#include <cmath>
+
+#include "Profile.hpp"
+PROFILED;
+
+SpatialHashGrid::SpatialHashGrid() { this->cell_size = DEFAULT_COLLISION_CELL_SIZE; }
+
+int SpatialHashGrid::GetCellSize() { return this->cell_size; }
+void SpatialHashGrid::SetCellSize(int cell_size) { this->cell_size = std::max(cell_size, 1); }
+
+uint64_t SpatialHashGrid::GetCellKey(int cell_x, int cell_y) {
+    return (uint64_t(uint32_t(cell_x)) << 32) | uint32_t(cell_y);
+}
+
+// Boxes are half open like SDL rects, so a box that ends exactly on a cell edge does not cover the
+// next cell
+static int GetCell(int coordinate, int cell_size) {
+    return static_cast<int>(std::floor(static_cast<double>(coordinate) / cell_size));
+}
+
+static bool BoxesOverlap(const SDL_Rect &box_1, const SDL_Rect &box_2) {
+    return box_1.x < box_2.x + box_2.w && box_2.x < box_1.x + box_1.w &&
+           box_1.y < box_2.y + box_2.h && box_2.y < box_1.y + box_1.h;
+}
+
+void SpatialHashGrid::Clear() {
+    this->boxes.clear();
+    this->filters.clear();
+    this->cell_entries.clear();
+    this->oversized.clear();
+    ClearAabbBatch(this->extents);
+}
+
+// Boxes are numbered in insertion order, and pairs refer to them by that number. Empty boxes can
+// never overlap anything, so they are numbered but not bucketed.
+void SpatialHashGrid::Insert(SDL_Rect box, CollisionFilter filter) {
+    uint32_t index = uint32_t(this->boxes.size());
+    this->boxes.push_back(box);
+    this->filters.push_back(filter);
+    AddToAabbBatch(this->extents, box);
+    if (box.w <= 0 || box.h <= 0) {
+        return;
+    }
+
+    int min_x = GetCell(box.x, this->cell_size);
+    int min_y = GetCell(box.y, this->cell_size);
+    int max_x = GetCell(box.x + box.w - 1, this->cell_size);
+    int max_y = GetCell(box.y + box.h - 1, this->cell_size);
+    if (size_t(max_x - min_x + 1) * size_t(max_y - min_y + 1) > MAX_CELLS_PER_BOX) {
+        this->oversized.push_back(index);
+        return;
+    }
+
+    for (int cell_x = min_x; cell_x <= max_x; cell_x++) {
+        for (int cell_y = min_y; cell_y <= max_y; cell_y++) {
+            this->cell_entries.emplace_back(this->GetCellKey(cell_x, cell_y), index);
+        }
+    }
+}
+
+// Emits every pair of overlapping boxes whose filters accept each other once, lower index first,
+// in ascending order. Two boxes can share several cells, so a pair is only emitted from the cell
+// holding the top left corner of their overlap.
+void SpatialHashGrid::GetCandidatePairs(std::vector<std::pair<uint32_t, uint32_t>> &pairs) {
+    ZoneScoped;
+
+    pairs.clear();
+    std::sort(this->cell_entries.begin(), this->cell_entries.end());
+
+    size_t begin = 0;
+    while (begin < this->cell_entries.size()) {
+        uint64_t cell_key = this->cell_entries[begin].first;
+        size_t end = begin + 1;
+        while (end < this->cell_entries.size() && this->cell_entries[end].first == cell_key) {
+            end++;
+        }
+
+        for (size_t i = begin; i < end; i++) {
+            uint32_t index_1 = this->cell_entries[i].second;
+            const SDL_Rect &box_1 = this->boxes[index_1];
+            for (size_t j = i + 1; j < end; j++) {
+                uint32_t index_2 = this->cell_entries[j].second;
+                const SDL_Rect &box_2 = this->boxes[index_2];
+                if (!CanCollide(this->filters[index_1], this->filters[index_2]) ||
+                    !BoxesOverlap(box_1, box_2)) {
+                    continue;
+                }
+
+                int corner_x = GetCell(std::max(box_1.x, box_2.x), this->cell_size);
+                int corner_y = GetCell(std::max(box_1.y, box_2.y), this->cell_size);
+                if (this->GetCellKey(corner_x, corner_y) == cell_key) {
+                    pairs.emplace_back(index_1, index_2);
+                }
+            }
+        }
+        begin = end;
+    }
+
+    // Oversized boxes are tested against every box at once, and only the hits are filtered
+    size_t box_count = this->boxes.size();
+    this->oversized_hits.resize(GetHitMaskWords(box_count));
+    for (uint32_t large : this->oversized) {
+        AabbOverlap::GetInstance().TestBox(this->extents, this->boxes[large], 0, box_count,
+                                           this->oversized_hits.data());
+        for (uint32_t other = 0; other < uint32_t(box_count); other++) {
+            if (other == large || !HasHit(this->oversized_hits.data(), other) ||
+                !CanCollide(this->filters[large], this->filters[other])) {
+                continue;
+            }
+
+            // Pairs of two oversized boxes are only emitted from the one with the lower index
+            if (other < large &&
+                std::binary_search(this->oversized.begin(), this->oversized.end(), other)) {
+                continue;
+            }
+            pairs.emplace_back(std::min(large, other), std::max(large, other));
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+}
+
+// Appends every box overlapping the query box once, reading the cells sorted by the last call to
+// GetCandidatePairs. A query covering too many cells tests every box with the overlap kernel
+// instead of walking its cells.
+void SpatialHashGrid::Query(SDL_Rect box, std::vector<uint32_t> &results) {
+    if (box.w <= 0 || box.h <= 0) {
+        return;
+    }
+
+    int min_x = GetCell(box.x, this->cell_size);
+    int min_y = GetCell(box.y, this->cell_size);
+    int max_x = GetCell(box.x + box.w - 1, this->cell_size);
+    int max_y = GetCell(box.y + box.h - 1, this->cell_size);
+    if (size_t(max_x - min_x + 1) * size_t(max_y - min_y + 1) > MAX_CELLS_PER_BOX) {
+        // Kept per thread, so a grid that is not being changed can be queried from several
+        // threads at once
+        static thread_local std::vector<uint64_t> query_hits;
+        size_t box_count = this->boxes.size();
+        query_hits.resize(GetHitMaskWords(box_count));
+        AabbOverlap::GetInstance().TestBox(this->extents, box, 0, box_count, query_hits.data());
+        for (uint32_t other = 0; other < uint32_t(box_count); other++) {
+            if (HasHit(query_hits.data(), other)) {
+                results.push_back(other);
+            }
+        }
+        return;
+    }
+
+    // A box sharing several cells with the query is only kept from the cell holding the top left
+    // corner of their overlap
+    for (int cell_x = min_x; cell_x <= max_x; cell_x++) {
+        for (int cell_y = min_y; cell_y <= max_y; cell_y++) {
+            uint64_t cell_key = this->GetCellKey(cell_x, cell_y);
+            auto entry = std::lower_bound(this->cell_entries.begin(), this->cell_entries.end(),
+                                          std::make_pair(cell_key, uint32_t(0)));
+            for (; entry != this->cell_entries.end() && entry->first == cell_key; ++entry) {
+                const SDL_Rect &other = this->boxes[entry->second];
+                if (!BoxesOverlap(box, other)) {
+                    continue;
+                }
+
+                int corner_x = GetCell(std::max(box.x, other.x), this->cell_size);
+                int corner_y = GetCell(std::max(box.y, other.y), this->cell_size);
+                if (corner_x == cell_x && corner_y == cell_y) {
+                    results.push_back(entry->second);
+                }
+            }
+        }
+    }
+
+    for (uint32_t large : this->oversized) {
+        if (BoxesOverlap(box, this->boxes[large])) {
+            results.push_back(large);
+        }
+    }
+}
\ No newline at end of file
@@ -7,48 +7,194 @@
 #include "Types.hpp"
 #include "Utils.hpp"
 #include <SDL_rect.h>
+#include <cmath>
 
 #include "Profile.hpp"
 PROFILED;
 
 Transform::Transform(Entity *entity) {
     this->entity = entity;
-    this->SetPosition(Position{0, 0});
+    this->pose_sequence.store(0);
+    this->position_x.store(0);
+    this->position_y.store(0);
+    this->angle.store(0);
+    this->idle_steps.store(0);
     this->size = Size{0, 0};
-    this->angle = 0;
     this->anchor = SDL_Point{0, 0};
+    this->previous_pose = Pose{};
+    this->previous_pose_saved = false;
+    this->dirty_sets.store(0);
 
     EventManager::GetInstance().Register({EventType::Move, EventType::Spawn}, this);
 }
 
-Position Transform::GetPosition() {
-    std::lock_guard<std::mutex> lock(this->position_mutex);
-    return this->position;
+Transform::~Transform() {
+    EventManager::GetInstance().Deregister({EventType::Move, EventType::Spawn}, this);
 }
-Size Transform::GetSize() { return this->size; }
-double Transform::GetAngle() {
-    std::lock_guard<std::mutex> lock(this->angle_mutex);
-    return this->angle;
+
+// Writers, which can be the engine loop and the network threads, are serialized by claiming the
+// odd sequence number
+uint32_t Transform::BeginPoseWrite() {
+    uint32_t sequence = this->pose_sequence.load(std::memory_order_relaxed);
+    while ((sequence & 1) != 0 ||
+           !this->pose_sequence.compare_exchange_weak(sequence, sequence + 1,
+                                                      std::memory_order_acquire)) {
+        sequence = this->pose_sequence.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    return sequence;
+}
+
+void Transform::EndPoseWrite(uint32_t sequence) {
+    this->pose_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void Transform::WritePose(Position position, double angle) {
+    uint32_t sequence = this->BeginPoseWrite();
+    this->position_x.store(position.x, std::memory_order_relaxed);
+    this->position_y.store(position.y, std::memory_order_relaxed);
+    this->angle.store(angle, std::memory_order_relaxed);
+    this->EndPoseWrite(sequence);
+    this->Wake();
+}
+
+Pose Transform::GetPose() {
+    Pose pose;
+    uint32_t sequence;
+    do {
+        sequence = this->pose_sequence.load(std::memory_order_acquire);
+        pose.position.x = this->position_x.load(std::memory_order_relaxed);
+        pose.position.y = this->position_y.load(std::memory_order_relaxed);
+        pose.angle = this->angle.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((sequence & 1) != 0 ||
+             sequence != this->pose_sequence.load(std::memory_order_relaxed));
+    return pose;
 }
+
+// Blends from the pose before the last simulation step towards the current one. Transforms that
+// were created since then, and angles that wrapped around, are not blended.
+Pose Transform::GetInterpolatedPose(double alpha) {
+    Pose pose = this->GetPose();
+    if (!this->previous_pose_saved || alpha >= 1) {
+        return pose;
+    }
+
+    Pose &previous = this->previous_pose;
+    pose.position.x = previous.position.x + float(alpha) * (pose.position.x - previous.position.x);
+    pose.position.y = previous.position.y + float(alpha) * (pose.position.y - previous.position.y);
+    if (std::abs(pose.angle - previous.angle) <= 180) {
+        pose.angle = previous.angle + alpha * (pose.angle - previous.angle);
+    }
+    return pose;
+}
+
+Position Transform::GetPosition() { return this->GetPose().position; }
+Size Transform::GetSize() { return this->size; }
+double Transform::GetAngle() { return this->angle.load(std::memory_order_acquire); }
 SDL_Point Transform::GetAnchor() { return this->anchor; }
 
-void Transform::SetPosition(Position position) {
+void Transform::SetPose(Position position, double angle) {
     ZoneScoped;
 
+#ifdef PROFILE
     std::string zone_text = this->entity->GetName() + " x: " + std::to_string(position.x) +
                             " y: " + std::to_string(position.y);
     ZoneText(zone_text.c_str(), zone_text.size());
+#endif
 
-    std::lock_guard<std::mutex> lock(this->position_mutex);
-    this->position = position;
+    this->WritePose(position, angle);
+    this->MarkDirty(DirtyMaskOf(DirtySet::Replay) | DirtyMaskOf(DirtySet::Render));
+}
+
+void Transform::SetPosition(Position position) {
+    uint32_t sequence = this->BeginPoseWrite();
+    this->position_x.store(position.x, std::memory_order_relaxed);
+    this->position_y.store(position.y, std::memory_order_relaxed);
+    this->EndPoseWrite(sequence);
+    this->Wake();
+    this->MarkDirty(DirtyMaskOf(DirtySet::Replay) | DirtyMaskOf(DirtySet::Render));
 }
 void Transform::SetSize(Size size) { this->size = size; }
 void Transform::SetAngle(double angle) {
-    std::lock_guard<std::mutex> lock(this->angle_mutex);
-    this->angle = angle;
+    uint32_t sequence = this->BeginPoseWrite();
+    this->angle.store(angle, std::memory_order_relaxed);
+    this->EndPoseWrite(sequence);
+    this->Wake();
+    this->MarkDirty(DirtyMaskOf(DirtySet::Replay) | DirtyMaskOf(DirtySet::Render));
 }
 void Transform::SetAnchor(SDL_Point anchor) { this->anchor = anchor; }
 
+void Transform::SavePreviousPose() {
+    this->previous_pose = this->GetPose();
+    this->previous_pose_saved = true;
+}
+
+// Fast path for locally simulated motion. The pose is written in place and the network set picks
+// it up at the end of the step, instead of a move event visiting every transform and a send update
+// event visiting every network component.
+void Transform::Move(Position position, double angle) {
+    if (this->MoveUnmarked(position, angle)) {
+        this->MarkMoved();
+    }
+}
+
+void Transform::Move(Position position) { this->Move(position, this->GetAngle()); }
+
+// Queuing a transform in a dirty set takes the engine's lock, so bodies moved from concurrent
+// chunks are written without it and marked by the caller afterwards. Returns whether the pose
+// changed.
+bool Transform::MoveUnmarked(Position position, double angle) {
+    Pose pose = this->GetPose();
+    if (pose.position.x == position.x && pose.position.y == position.y && pose.angle == angle) {
+        return false;
+    }
+
+    this->WritePose(position, angle);
+    return true;
+}
+
+bool Transform::MoveUnmarked(Position position) {
+    return this->MoveUnmarked(position, this->GetAngle());
+}
+
+void Transform::MarkMoved() {
+    this->MarkDirty(DirtyMaskOf(DirtySet::Replay) | DirtyMaskOf(DirtySet::Render) |
+                    DirtyMaskOf(DirtySet::Network));
+}
+
+// Entities outside the engine have nobody consuming their changes, except for the camera, which is
+// never added to the engine but is still recorded and interpolated
+void Transform::MarkDirty(DirtyMask mask) {
+    if (!this->entity->IsInEngine() && this->entity->GetCategory() != EntityCategory::Camera) {
+        return;
+    }
+
+    DirtyMask added = mask & ~this->dirty_sets.fetch_or(mask);
+    if (added != 0) {
+        Engine::GetInstance().AddDirtyTransform(this->entity, added);
+    }
+}
+
+void Transform::ClearDirty(DirtySet set) {
+    this->dirty_sets.fetch_and(DirtyMask(~DirtyMaskOf(set)));
+}
+
+bool Transform::IsSleeping() { return this->idle_steps.load() >= SLEEP_STEPS; }
+
+// Any thread that moves the transform wakes it, including the network threads
+void Transform::Wake() { this->idle_steps.store(0); }
+
+// Called by the engine loop once per simulation step. The counter is only ever incremented, so a
+// concurrent Wake is never overwritten by a stale count.
+void Transform::UpdateSleep(bool moving) {
+    if (moving) {
+        this->Wake();
+    } else if (this->idle_steps.load() < SLEEP_STEPS) {
+        this->idle_steps.fetch_add(1);
+    }
+}
+
 void Transform::Update() {};
 
 void Transform::OnEvent(Event event) {
@@ -58,10 +204,10 @@ void Transform::OnEvent(Event event) {
     case EventType::Move: {
         MoveEvent *move_event = std::get_if<MoveEvent>(&(event.data));
         if (move_event) {
-            if (this->entity == move_event->entity) {
-                this->SetPosition(move_event->position);
-                this->SetAngle(move_event->angle);
-                EventManager::GetInstance().RaiseSendUpdateEvent(SendUpdateEvent{this->entity});
+            if (this->entity->GetId() == move_event->entity) {
+                this->SetPose(move_event->position, move_event->angle);
+                EventManager::GetInstance().RaiseSendUpdateEvent(
+                    SendUpdateEvent{this->entity->GetId()});
             }
         }
 
@@ -71,9 +217,8 @@ void Transform::OnEvent(Event event) {
     case EventType::Spawn: {
         SpawnEvent *spawn_event = std::get_if<SpawnEvent>(&(event.data));
         if (spawn_event) {
-            if (this->entity == GetClientPlayer(Engine::GetInstance().GetNetworkInfo().id,
-                                                Engine::GetInstance().GetEntities())) {
-                if (this->entity == spawn_event->entity) {
+            if (this->entity == Engine::GetInstance().GetLocalPlayer()) {
+                if (this->entity->GetId() == spawn_event->entity) {
                     this->entity->GetComponent<Render>()->SetVisible(true);
                     Engine::GetInstance().RespawnPlayer();
                 }
@@ -0,0 +1,115 @@
+#include "TriggerIndex.hpp"
+#include "AabbOverlap.hpp"
+#include "Types.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+#include <cmath>
+
+#include "Profile.hpp"
+PROFILED;
+
+static uint64_t PackEntityId(EntityId entity_id) {
+    return (static_cast<uint64_t>(entity_id.generation) << 32) | entity_id.index;
+}
+
+static EntityId UnpackEntityId(uint64_t packed) {
+    return EntityId{static_cast<uint32_t>(packed), static_cast<uint32_t>(packed >> 32)};
+}
+
+static bool IsBefore(const TriggerOverlap &overlap_1, const TriggerOverlap &overlap_2) {
+    return overlap_1.entity < overlap_2.entity ||
+           (overlap_1.entity == overlap_2.entity && overlap_1.trigger < overlap_2.trigger);
+}
+
+void TriggerIndex::Add(EntityCategory category, Position position, Size size, bool follows_camera) {
+    int index = this->GetCount(category);
+    this->triggers.push_back(Trigger{category, index, position, size, follows_camera});
+}
+
+const std::vector<Trigger> &TriggerIndex::GetTriggers() { return this->triggers; }
+
+const Trigger *TriggerIndex::Find(EntityCategory category, int index) {
+    for (const Trigger &trigger : this->triggers) {
+        if (trigger.category == category && trigger.index == index) {
+            return &trigger;
+        }
+    }
+    return nullptr;
+}
+
+int TriggerIndex::GetCount(EntityCategory category) {
+    return static_cast<int>(std::count_if(
+        this->triggers.begin(), this->triggers.end(),
+        [category](const Trigger &trigger) { return trigger.category == category; }));
+}
+
+SDL_Rect TriggerIndex::GetBox(const Trigger &trigger, Position camera_position) {
+    Position position = trigger.position;
+    if (trigger.follows_camera) {
+        position = Position{position.x + camera_position.x, position.y + camera_position.y};
+    }
+    return SDL_Rect{static_cast<int>(std::round(position.x)),
+                    static_cast<int>(std::round(position.y)), trigger.size.width,
+                    trigger.size.height};
+}
+
+void TriggerIndex::Test(const std::vector<std::pair<EntityId, SDL_Rect>> &entities,
+                        Position camera_position, std::vector<TriggerContact> &contacts) {
+    ZoneScoped;
+
+    contacts.clear();
+    this->previous_overlaps.swap(this->overlaps);
+    this->overlaps.clear();
+
+    size_t trigger_count = this->triggers.size();
+    if (trigger_count > 0) {
+        ClearAabbBatch(this->boxes);
+        for (const Trigger &trigger : this->triggers) {
+            AddToAabbBatch(this->boxes, this->GetBox(trigger, camera_position));
+        }
+        this->hits.resize(GetHitMaskWords(trigger_count));
+
+        for (const std::pair<EntityId, SDL_Rect> &entity : entities) {
+            AabbOverlap::GetInstance().TestBox(this->boxes, entity.second, 0, trigger_count,
+                                               this->hits.data());
+            for (uint32_t trigger = 0; trigger < uint32_t(trigger_count); trigger++) {
+                if (HasHit(this->hits.data(), trigger)) {
+                    ContactManifold manifold = GetContactManifold(
+                        entity.second, this->GetBox(this->triggers[trigger], camera_position));
+                    this->overlaps.push_back(
+                        TriggerOverlap{PackEntityId(entity.first), trigger, manifold});
+                }
+            }
+        }
+        std::sort(this->overlaps.begin(), this->overlaps.end(), IsBefore);
+    }
+
+    // Both lists are sorted, so a single merge tells the overlaps that started, went on and ended
+    const std::vector<TriggerOverlap> &current = this->overlaps;
+    const std::vector<TriggerOverlap> &previous = this->previous_overlaps;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < current.size() || j < previous.size()) {
+        if (j == previous.size() || (i < current.size() && IsBefore(current[i], previous[j]))) {
+            contacts.push_back(TriggerContact{UnpackEntityId(current[i].entity), current[i].trigger,
+                                              ContactPhase::Enter, current[i].manifold});
+            i++;
+        } else if (i == current.size() || IsBefore(previous[j], current[i])) {
+            contacts.push_back(TriggerContact{UnpackEntityId(previous[j].entity),
+                                              previous[j].trigger, ContactPhase::Exit,
+                                              previous[j].manifold});
+            j++;
+        } else {
+            contacts.push_back(TriggerContact{UnpackEntityId(current[i].entity), current[i].trigger,
+                                              ContactPhase::Stay, current[i].manifold});
+            i++;
+            j++;
+        }
+    }
+}
+
+void TriggerIndex::Clear() {
+    this->triggers.clear();
+    this->overlaps.clear();
+    this->previous_overlaps.clear();
+}
\ No newline at end of file
@@ -7,16 +7,31 @@
 #include "SDL_log.h"
 #include "Types.hpp"
 #include <algorithm>
+#include <limits>
+#include <mutex>
 #include <random>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
+// Textures are cached by path, so entities that are spawned over and over share one texture instead
+// of loading the image again
 SDL_Texture *LoadTexture(std::string path) {
+    static std::mutex texture_cache_mutex;
+    static std::unordered_map<std::string, SDL_Texture *> texture_cache;
+
     path = GetAssetPath(path);
 
     if (app->renderer == nullptr) {
         return NULL;
     }
 
+    std::lock_guard<std::mutex> lock(texture_cache_mutex);
+    auto iterator = texture_cache.find(path);
+    if (iterator != texture_cache.end()) {
+        return iterator->second;
+    }
+
     SDL_Surface *surface = IMG_Load(path.c_str());
     if (surface == NULL) {
         Log(LogLevel::Error, "Error: \'%s\' while loading the image file: %s", IMG_GetError(),
@@ -41,6 +56,7 @@ SDL_Texture *LoadTexture(std::string path) {
         return NULL;
     }
 
+    texture_cache[path] = texture;
     return texture;
 }
 
@@ -91,7 +107,12 @@ void Log(LogLevel log_level, const char *fmt, ...) {
 Size GetWindowSize() { return Size{app->window.width, app->window.height}; }
 
 Overlap GetOverlap(SDL_Rect rect_1, SDL_Rect rect_2) {
-    Overlap overlap = Overlap::None;
+    return GetContactManifold(rect_1, rect_2).side;
+}
+
+// The boxes touch along the axis they overlap the least on
+ContactManifold GetContactManifold(SDL_Rect rect_1, SDL_Rect rect_2) {
+    ContactManifold manifold;
 
     int left_overlap = (rect_1.x + rect_1.w) - rect_2.x;
     int right_overlap = (rect_2.x + rect_2.w) - rect_1.x;
@@ -102,18 +123,84 @@ Overlap GetOverlap(SDL_Rect rect_1, SDL_Rect rect_2) {
         std::min(std::min(left_overlap, right_overlap), std::min(top_overlap, bottom_overlap));
 
     if (min_overlap == left_overlap) {
-        overlap = Overlap::Left;
+        manifold = ContactManifold{Overlap::Left, min_overlap, Position{1, 0}};
     } else if (min_overlap == right_overlap) {
-        overlap = Overlap::Right;
+        manifold = ContactManifold{Overlap::Right, min_overlap, Position{-1, 0}};
     } else if (min_overlap == top_overlap) {
-        overlap = Overlap::Top;
+        manifold = ContactManifold{Overlap::Top, min_overlap, Position{0, 1}};
     } else if (min_overlap == bottom_overlap) {
-        overlap = Overlap::Bottom;
+        manifold = ContactManifold{Overlap::Bottom, min_overlap, Position{0, -1}};
     }
-    return overlap;
+    return manifold;
 }
 
-Entity *GetEntityByName(std::string name, std::vector<Entity *> entities) {
+// The same contact seen from the second box
+ContactManifold FlipManifold(const ContactManifold &manifold) {
+    Overlap side = Overlap::None;
+    switch (manifold.side) {
+    case Overlap::Left:
+        side = Overlap::Right;
+        break;
+    case Overlap::Right:
+        side = Overlap::Left;
+        break;
+    case Overlap::Top:
+        side = Overlap::Bottom;
+        break;
+    case Overlap::Bottom:
+        side = Overlap::Top;
+        break;
+    default:
+        break;
+    }
+    return ContactManifold{side, manifold.depth, Position{-manifold.normal.x, -manifold.normal.y}};
+}
+
+// Entry and exit times of a box moving along one axis through the span of another box. An axis
+// without motion either always overlaps or never does.
+static bool GetAxisEntryExit(float moving_min, float moving_max, float delta, float target_min,
+                             float target_max, float &entry, float &exit) {
+    const float INFINITE = std::numeric_limits<float>::infinity();
+
+    if (delta > 0) {
+        entry = (target_min - moving_max) / delta;
+        exit = (target_max - moving_min) / delta;
+    } else if (delta < 0) {
+        entry = (target_max - moving_min) / delta;
+        exit = (target_min - moving_max) / delta;
+    } else {
+        if (moving_max <= target_min || moving_min >= target_max) {
+            return false;
+        }
+        entry = -INFINITE;
+        exit = INFINITE;
+    }
+    return true;
+}
+
+// Swept AABB test. Finds the fraction of the displacement at which the moving box first touches
+// the target box. Boxes that already overlap at the start are left to the discrete test.
+bool GetTimeOfImpact(SDL_Rect moving, Position displacement, SDL_Rect target,
+                     float &time_of_impact) {
+    float entry_x, exit_x, entry_y, exit_y;
+    if (!GetAxisEntryExit(float(moving.x), float(moving.x + moving.w), displacement.x,
+                          float(target.x), float(target.x + target.w), entry_x, exit_x) ||
+        !GetAxisEntryExit(float(moving.y), float(moving.y + moving.h), displacement.y,
+                          float(target.y), float(target.y + target.h), entry_y, exit_y)) {
+        return false;
+    }
+
+    float entry = std::max(entry_x, entry_y);
+    float exit = std::min(exit_x, exit_y);
+    if (entry >= exit || entry < 0 || entry > 1) {
+        return false;
+    }
+
+    time_of_impact = entry;
+    return true;
+}
+
+Entity *GetEntityByName(std::string name, const std::vector<Entity *> &entities) {
     for (Entity *entity : entities) {
         if (entity->GetName() == name) {
             return entity;
@@ -122,7 +209,7 @@ Entity *GetEntityByName(std::string name, std::vector<Entity *> entities) {
     return nullptr;
 }
 
-Entity *GetControllable(std::vector<Entity *> entities) {
+Entity *GetControllable(const std::vector<Entity *> &entities) {
     for (Entity *entity : entities) {
         if (entity->GetCategory() == EntityCategory::Controllable) {
             return entity;
@@ -131,7 +218,7 @@ Entity *GetControllable(std::vector<Entity *> entities) {
     return nullptr;
 }
 
-int GetControllableCount(std::vector<Entity *> entities) {
+int GetControllableCount(const std::vector<Entity *> &entities) {
     int controllable_count = 0;
 
     for (Entity *entity : entities) {
@@ -143,7 +230,8 @@ int GetControllableCount(std::vector<Entity *> entities) {
     return controllable_count;
 }
 
-std::vector<Entity *> GetEntitiesByRole(NetworkInfo network_info, std::vector<Entity *> entities) {
+std::vector<Entity *> GetEntitiesByRole(NetworkInfo network_info,
+                                        const std::vector<Entity *> &entities) {
     std::vector<Entity *> entity_list;
 
     if (network_info.mode == NetworkMode::Single) {
@@ -168,7 +256,7 @@ std::vector<Entity *> GetEntitiesByRole(NetworkInfo network_info, std::vector<En
             }
         }
 
-        entity_list.push_back(GetClientPlayer(network_info.id, entities));
+        entity_list.push_back(Engine::GetInstance().GetLocalPlayer());
     }
 
     return entity_list;
@@ -186,28 +274,6 @@ void SetPlayerTexture(Entity *controllable, int player_id, int player_textures)
     controllable->GetComponent<Render>()->SetTexture(texture_template);
 }
 
-Entity *GetClientPlayer(int player_id, std::vector<Entity *> entities) {
-    for (Entity *entity : entities) {
-        if (entity->GetCategory() == EntityCategory::Controllable) {
-            std::string name = entity->GetName();
-            size_t underscore = name.rfind('_');
-
-            if (underscore != std::string::npos && (underscore + 1) < name.size()) {
-                std::string number = name.substr(underscore + 1);
-                try {
-                    int player = std::stoi(number);
-                    if (player == player_id) {
-                        return entity;
-                    }
-                } catch (const std::invalid_argument &e) {
-                    Log(LogLevel::Error, "Could not locate the client player to update");
-                }
-            }
-        }
-    }
-    return nullptr;
-}
-
 bool SetEngineCLIOptions(int argc, char *args[]) {
     std::string mode;
     std::string role;
@@ -215,6 +281,7 @@ bool SetEngineCLIOptions(int argc, char *args[]) {
     std::string host_ip;
     std::string peer_ip;
     std::string encoding;
+    std::string tick_rate;
     std::vector<std::string> valid_modes = {"single", "cs", "p2p"};
     std::vector<std::string> valid_roles = {"server", "client", "host", "peer"};
     std::vector<std::string> valid_encodings = {"struct", "json"};
@@ -240,6 +307,9 @@ bool SetEngineCLIOptions(int argc, char *args[]) {
         } else if (arg == "--encoding" && i + 1 < argc) {
             encoding = args[i + 1];
             i++;
+        } else if (arg == "--tick_rate" && i + 1 < argc) {
+            tick_rate = args[i + 1];
+            i++;
         }
     }
 
@@ -314,6 +384,19 @@ bool SetEngineCLIOptions(int argc, char *args[]) {
         return false;
     }
 
+    int engine_tick_rate = 0;
+    if (!tick_rate.empty()) {
+        try {
+            engine_tick_rate = std::stoi(tick_rate);
+        } catch (const std::exception &e) {
+            engine_tick_rate = -1;
+        }
+        if (engine_tick_rate < 0) {
+            Log(LogLevel::Error, "Invalid tick rate. Must be a non-negative number");
+            return false;
+        }
+    }
+
     NetworkMode network_mode;
     NetworkRole network_role;
     Encoding engine_encoding;
@@ -351,6 +434,7 @@ bool SetEngineCLIOptions(int argc, char *args[]) {
     Engine::GetInstance().SetNetworkInfo(
         NetworkInfo{network_mode, network_role, 0, server_ip, host_ip, peer_ip});
     Engine::GetInstance().SetEncoding(engine_encoding);
+    Engine::GetInstance().SetTickRate(engine_tick_rate);
 
     return true;
 }
@@ -416,7 +500,22 @@ bool IsZoneCategory(EntityCategory category) {
     return std::find(zones.begin(), zones.end(), category) != zones.end();
 }
 
-std::vector<Entity *> GetEntitiesByCategory(std::vector<Entity *> entities,
+// Both layers have to be in the other side's mask and at least one side needs a Collision
+// component. Zones only meet the local player, and players never meet each other.
+bool CanCollide(const CollisionFilter &filter_1, const CollisionFilter &filter_2) {
+    if ((filter_1.mask & filter_2.layer) == 0 || (filter_2.mask & filter_1.layer) == 0) {
+        return false;
+    }
+    if (!filter_1.body && !filter_2.body) {
+        return false;
+    }
+    if ((filter_1.zone && !filter_2.player) || (filter_2.zone && !filter_1.player)) {
+        return false;
+    }
+    return !(filter_1.controllable && filter_2.controllable);
+}
+
+std::vector<Entity *> GetEntitiesByCategory(const std::vector<Entity *> &entities,
                                             EntityCategory category) {
     std::vector<Entity *> filtered_entities;
     for (Entity *entity : entities) {
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Types.hpp"
+#include <SDL_rect.h>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using OverlapPairsKernel = void (*)(const AabbBatch &boxes,
+                                    const std::pair<uint32_t, uint32_t> *pairs, size_t begin,
+                                    size_t end, uint64_t *hits);
+using OverlapBoxKernel = void (*)(const AabbBatch &boxes, SDL_Rect box, size_t begin, size_t end,
+                                  uint64_t *hits);
+
+// Tests boxes for overlap with the widest vector kernel the CPU supports, several pairs per
+// instruction. Results are written as hit masks with one bit per pair or box. Ranges have to start
+// on a word boundary, so ranges tested concurrently never share a word.
+class AabbOverlap {
+  public:
+    static AabbOverlap &GetInstance() {
+        static AabbOverlap instance;
+        return instance;
+    }
+
+  private:
+    AabbOverlap();
+
+    OverlapPairsKernel pairs_kernel;
+    OverlapBoxKernel box_kernel;
+    const char *kernel_name;
+
+  public:
+    AabbOverlap(AabbOverlap const &) = delete;
+    void operator=(AabbOverlap const &) = delete;
+
+    const char *GetKernelName();
+    // Tests boxes[pairs[i].first] against boxes[pairs[i].second] for every i in [begin, end)
+    void TestPairs(const AabbBatch &boxes, const std::pair<uint32_t, uint32_t> *pairs,
+                   size_t begin, size_t end, uint64_t *hits);
+    // Tests one box against boxes [begin, end)
+    void TestBox(const AabbBatch &boxes, SDL_Rect box, size_t begin, size_t end, uint64_t *hits);
+};
+
+void ClearAabbBatch(AabbBatch &batch);
+void AddToAabbBatch(AabbBatch &batch, SDL_Rect box);
+size_t GetHitMaskWords(size_t count);
+
+inline bool HasHit(const uint64_t *hits, size_t index) {
+    return (hits[index / HIT_MASK_WORD_BITS] >> (index % HIT_MASK_WORD_BITS)) & 1;
+}
+
+// Finds where the segment from start to end first enters the box, as a fraction of its length,
+// and the normal of the side it enters through. Segments starting inside hit at 0 with no normal.
+bool GetRayHit(Position start, Position end, const SDL_Rect &box, float &fraction,
+               Position &normal);
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Types.hpp"
+#include <SDL_rect.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bounding volume hierarchy over boxes that do not move. It is built top down in one go, splitting
+// every node at the median centre along its longer side, and stored flat with the left child right
+// after its parent.
+class StaticAabbTree {
+  private:
+    struct Node {
+        SDL_Rect box;
+        // Leaves own count boxes starting at first in box_order, inner nodes have a count of 0
+        uint32_t first;
+        uint32_t count;
+        uint32_t right;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<SDL_Rect> boxes;
+    std::vector<uint32_t> box_order;
+
+    uint32_t BuildNode(uint32_t begin, uint32_t end);
+
+  public:
+    void Build(const std::vector<SDL_Rect> &boxes);
+    void Query(SDL_Rect box, std::vector<uint32_t> &results);
+    void RayCast(Position start, Position end, std::vector<uint32_t> &results);
+};
+
+// Incrementally updated tree over moving boxes. Leaves hold fattened boxes, so a body is only
+// reinserted once it leaves its fat box, and insertions keep the tree balanced with rotations.
+class DynamicAabbTree {
+  private:
+    struct Node {
+        SDL_Rect box;
+        int parent;
+        int child_1;
+        int child_2;
+        int height;
+        uint32_t user;
+    };
+
+    std::vector<Node> nodes;
+    int root;
+    // Freed nodes are chained through their parent index
+    int free_node;
+
+    int AllocateNode();
+    void FreeNode(int node);
+    bool IsLeaf(int node);
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+    void Refit(int node);
+    int Balance(int node);
+
+  public:
+    DynamicAabbTree();
+
+    int CreateProxy(SDL_Rect box, uint32_t user);
+    void DestroyProxy(int proxy);
+    bool MoveProxy(int proxy, SDL_Rect box);
+    void SetUser(int proxy, uint32_t user);
+    void Query(SDL_Rect box, std::vector<uint32_t> &results);
+    void RayCast(Position start, Position end, std::vector<uint32_t> &results);
+};
\ No newline at end of file
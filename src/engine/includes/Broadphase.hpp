@@ -0,0 +1,58 @@
+#pragma once
+
+#include "AabbTree.hpp"
+#include "SpatialHashGrid.hpp"
+#include "Types.hpp"
+#include <SDL_rect.h>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Finds the pairs of colliders whose filters accept each other and whose boxes overlap, for the
+// narrowphase in Engine::TestCollision. In grid mode every collider is bucketed into a uniform
+// grid each step. In tree mode stationary colliders sit in a tree that is only rebuilt when they
+// change, moving ones sit in a tree that is updated incrementally, and only awake colliders run
+// queries, so pairs of two sleeping colliders are never tested. Stationary colliders only sleep
+// while they stay where they are. Both modes report the same pairs.
+class Broadphase {
+  private:
+    BroadphaseMode mode;
+    // Box of every collider this step, swept colliders cover their whole sweep
+    std::vector<SDL_Rect> boxes;
+    std::vector<uint32_t> query_results;
+
+    SpatialHashGrid grid;
+
+    StaticAabbTree static_tree;
+    std::vector<std::pair<Entity *, SDL_Rect>> static_leaves;
+    std::vector<uint32_t> static_colliders;
+
+    DynamicAabbTree dynamic_tree;
+    // Proxy of every moving entity and the last step it was seen in
+    std::unordered_map<Entity *, std::pair<int, uint64_t>> dynamic_proxies;
+    std::vector<uint32_t> dynamic_colliders;
+    uint64_t step;
+
+    void FindGridPairs(const std::vector<Collider> &colliders, size_t awake_count,
+                       std::vector<std::pair<uint32_t, uint32_t>> &pairs);
+    void FindTreePairs(const std::vector<Collider> &colliders, size_t awake_count,
+                       std::vector<std::pair<uint32_t, uint32_t>> &pairs);
+    void UpdateStaticTree(const std::vector<Collider> &colliders);
+    void UpdateDynamicTree(const std::vector<Collider> &colliders);
+
+  public:
+    Broadphase();
+
+    BroadphaseMode GetMode();
+    void SetMode(BroadphaseMode mode);
+    void SetCellSize(int cell_size);
+
+    // Colliders come awake first, and pairs of two colliders past awake_count are left out
+    void FindPairs(const std::vector<Collider> &colliders, size_t awake_count,
+                   std::vector<std::pair<uint32_t, uint32_t>> &pairs);
+    // Append the colliders of the last FindPairs that may touch the box or the segment, each once
+    // and in no particular order
+    void QueryBox(SDL_Rect box, std::vector<uint32_t> &results);
+    void QueryRay(Position start, Position end, std::vector<uint32_t> &results);
+};
\ No newline at end of file
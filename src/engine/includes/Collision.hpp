@@ -3,23 +3,43 @@
 #include "Component.hpp"
 #include "Entity.hpp"
 #include "EventHandler.hpp"
+#include "Types.hpp"
 
 class Collision : public Component, public EventHandler {
   private:
     Entity *entity;
     float restitution;
     bool avoid_transform;
-
-    void HandlePairwiseCollision(Entity *collider);
+    int layer;
+    CollisionMask mask;
+    // Continuous collision sweeps the box from where the integrator started it this step
+    bool continuous;
+    bool has_sweep;
+    Position sweep_start;
+    Position sweep_end;
 
   public:
     Collision(Entity *entity);
+    ~Collision();
 
     float GetRestitution();
     bool GetAvoidTransform();
+    bool GetContinuous();
+    int GetLayer();
+    CollisionMask GetMask();
 
     void SetRestitution(float restitution);
     void SetAvoidTransform(bool avoid_transform);
+    // Fast bodies that could pass through thin colliders in one step should be continuous
+    void SetContinuous(bool continuous);
+    void SetLayer(int layer);
+    // Layers this body tests against, built from CollisionMaskOf
+    void SetMask(CollisionMask mask);
+
+    void SetSweep(Position start, Position end);
+    bool TakeSweep(Position end, Position &start);
+
+    void HandlePairwiseCollision(Entity *collider, const ContactManifold &manifold);
 
     void Update() override;
     void OnEvent(Event event) override;
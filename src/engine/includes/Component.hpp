@@ -1,7 +1,48 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 class Component {
   public:
     virtual ~Component() = default;
     virtual void Update() = 0;
-};
\ No newline at end of file
+};
+
+class Transform;
+class Physics;
+class Render;
+class Collision;
+class Handler;
+class Network;
+
+// Compile-time slot of each component type in an entity's fixed component table
+template <typename T> struct ComponentType;
+
+template <> struct ComponentType<Transform> {
+    static constexpr size_t ID = 0;
+};
+template <> struct ComponentType<Physics> {
+    static constexpr size_t ID = 1;
+};
+template <> struct ComponentType<Render> {
+    static constexpr size_t ID = 2;
+};
+template <> struct ComponentType<Collision> {
+    static constexpr size_t ID = 3;
+};
+template <> struct ComponentType<Handler> {
+    static constexpr size_t ID = 4;
+};
+template <> struct ComponentType<Network> {
+    static constexpr size_t ID = 5;
+};
+
+constexpr size_t MAX_COMPONENTS = 6;
+
+// One bit per component type, set for every component an entity has
+using ComponentMask = uint32_t;
+
+template <typename... Components> constexpr ComponentMask ComponentMaskOf() {
+    return (ComponentMask(0) | ... | (ComponentMask(1) << ComponentType<Components>::ID));
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+class Entity;
+
+// Dense storage for every component of type T. Components live back to back in fixed-size chunks
+// so the engine systems can walk them in memory order instead of chasing one heap object per
+// entity. Chunks are never moved, which keeps component addresses stable for event handlers.
+template <typename T> class ComponentStorage {
+  public:
+    static ComponentStorage &GetInstance() {
+        static ComponentStorage instance;
+        return instance;
+    }
+
+    static constexpr size_t CHUNK_SIZE = 256;
+    static constexpr size_t MAX_CHUNKS = 4096;
+
+  private:
+    ComponentStorage() {}
+    ~ComponentStorage() {
+        for (auto &chunk : this->chunks) {
+            delete chunk.load();
+        }
+    }
+
+    struct Chunk {
+        alignas(T) unsigned char data[CHUNK_SIZE * sizeof(T)];
+        std::array<std::atomic<Entity *>, CHUNK_SIZE> owners{};
+
+        T *Get(size_t index) { return std::launder(reinterpret_cast<T *>(data) + index); }
+    };
+
+    std::mutex storage_mutex;
+    std::array<std::atomic<Chunk *>, MAX_CHUNKS> chunks{};
+    std::atomic<size_t> slot_count{0};
+    std::vector<size_t> free_slots;
+
+  public:
+    ComponentStorage(ComponentStorage const &) = delete;
+    void operator=(ComponentStorage const &) = delete;
+
+    T *Create(Entity *entity, size_t &slot);
+    void Destroy(size_t slot);
+    static void Release(size_t slot) { GetInstance().Destroy(slot); }
+
+    // Calls function(entity, component) for every live component, in storage order
+    template <typename Function> void ForEach(Function function);
+};
+
+template <typename T> T *ComponentStorage<T>::Create(Entity *entity, size_t &slot) {
+    std::lock_guard<std::mutex> lock(this->storage_mutex);
+
+    size_t count = this->slot_count.load(std::memory_order_relaxed);
+    if (!this->free_slots.empty()) {
+        slot = this->free_slots.back();
+        this->free_slots.pop_back();
+    } else {
+        slot = count;
+    }
+
+    size_t chunk_index = slot / CHUNK_SIZE;
+    Chunk *chunk = this->chunks[chunk_index].load(std::memory_order_relaxed);
+    if (chunk == nullptr) {
+        chunk = new Chunk();
+        this->chunks[chunk_index].store(chunk, std::memory_order_release);
+    }
+
+    T *component = new (chunk->data + (slot % CHUNK_SIZE) * sizeof(T)) T(entity);
+    chunk->owners[slot % CHUNK_SIZE].store(entity, std::memory_order_release);
+    if (slot == count) {
+        this->slot_count.store(count + 1, std::memory_order_release);
+    }
+
+    return component;
+}
+
+template <typename T> void ComponentStorage<T>::Destroy(size_t slot) {
+    std::lock_guard<std::mutex> lock(this->storage_mutex);
+
+    Chunk *chunk = this->chunks[slot / CHUNK_SIZE].load(std::memory_order_relaxed);
+    chunk->owners[slot % CHUNK_SIZE].store(nullptr, std::memory_order_release);
+    chunk->Get(slot % CHUNK_SIZE)->~T();
+    this->free_slots.push_back(slot);
+}
+
+template <typename T>
+template <typename Function>
+void ComponentStorage<T>::ForEach(Function function) {
+    size_t count = this->slot_count.load(std::memory_order_acquire);
+
+    for (size_t chunk_index = 0; chunk_index * CHUNK_SIZE < count; chunk_index++) {
+        Chunk *chunk = this->chunks[chunk_index].load(std::memory_order_acquire);
+        size_t chunk_end = std::min(CHUNK_SIZE, count - chunk_index * CHUNK_SIZE);
+
+        for (size_t i = 0; i < chunk_end; i++) {
+            Entity *owner = chunk->owners[i].load(std::memory_order_acquire);
+            if (owner != nullptr) {
+                function(*owner, *chunk->Get(i));
+            }
+        }
+    }
+}
\ No newline at end of file
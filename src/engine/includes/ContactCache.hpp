@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Types.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Pairs of entities that were touching at the end of the last step. The narrowphase reports every
+// touching pair each step, and the cache turns that into enter, stay and exit phases, so a resting
+// contact is only announced when it starts and when it ends. Pairs have to be reported with their
+// entities in the same order every step. Two sleeping bodies are never tested against each other,
+// so a contact between them is kept for as long as both stay asleep.
+class ContactCache {
+  private:
+    struct Contact {
+        EntityId collider_1;
+        EntityId collider_2;
+        ContactManifold manifold;
+        uint64_t step;
+    };
+
+    struct ContactKeyHash {
+        size_t operator()(const std::pair<uint64_t, uint64_t> &key) const;
+    };
+
+    std::unordered_map<std::pair<uint64_t, uint64_t>, Contact, ContactKeyHash> contacts;
+    uint64_t step;
+
+  public:
+    ContactCache();
+
+    // Starts a step, carrying over the contacts between sleeping bodies
+    void BeginStep();
+    // Records a touching pair and tells whether it just started touching
+    ContactPhase Touch(EntityId collider_1, EntityId collider_2, const ContactManifold &manifold);
+    // Removes the pairs that were neither touched nor carried over this step, as exit events
+    void TakeExits(std::vector<CollisionEvent> &exits);
+    void Clear();
+};
\ No newline at end of file
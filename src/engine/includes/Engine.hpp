@@ -1,11 +1,15 @@
 #pragma once
 
 #include "App.hpp"
+#include "Broadphase.hpp"
+#include "ContactCache.hpp"
 #include "EngineHandler.hpp"
 #include "Entity.hpp"
 #include "Input.hpp"
 #include "Timeline.hpp"
+#include "TriggerIndex.hpp"
 #include "Types.hpp"
+#include <array>
 #include <atomic>
 #include <functional>
 #include <memory>
@@ -17,6 +21,9 @@
 
 extern App *app;
 
+class Handler;
+class Render;
+
 class Engine {
   public:
     static Engine &GetInstance() {
@@ -39,10 +46,17 @@ class Engine {
     NetworkInfo network_info;
     Encoding encoding;
     std::atomic<int> players_connected;
+    std::mutex players_mutex;
+    std::unordered_map<int, Entity *> players;
+    std::atomic<Entity *> local_player;
     Color background_color;
     bool show_player_border;
     int player_textures;
     int max_players;
+    int tick_rate;
+    int max_substeps;
+    int64_t step_accumulator;
+    double interpolation_alpha;
 
     std::shared_ptr<Entity> camera;
     bool show_zone_borders;
@@ -52,7 +66,42 @@ class Engine {
 
     std::mutex entities_mutex;
     std::vector<Entity *> entities;
-    std::unordered_map<Entity *, std::pair<Position, double>> entity_transforms;
+    std::vector<Entity *> removed_entities;
+    std::vector<std::pair<uint64_t, Entity *>> retired_entities;
+    std::vector<Entity *> reclaimed_entities;
+    std::atomic<EntitySnapshot *> entity_snapshot;
+    std::vector<std::pair<uint64_t, EntitySnapshot *>> retired_snapshots;
+    std::vector<EntitySnapshot *> free_snapshots;
+    std::unordered_map<ComponentMask, std::vector<Entity *>> component_views;
+    std::array<std::vector<Entity *>, ENTITY_CATEGORY_COUNT> category_views;
+    std::array<std::vector<Entity *>, MAX_TAGS> tag_views;
+    std::mutex tags_mutex;
+    std::unordered_map<std::string, int> tag_ids;
+    std::mutex entity_commands_mutex;
+    std::vector<EntityCommand> entity_commands;
+    std::vector<EntityCommand> applied_entity_commands;
+    std::vector<Collider> colliders;
+    Broadphase broadphase;
+    std::array<CollisionMask, MAX_COLLISION_LAYERS> collision_matrix;
+    std::vector<std::pair<uint32_t, uint32_t>> collision_pairs;
+    AabbBatch collider_boxes;
+    std::vector<uint64_t> overlap_hits;
+    // One buffer per chunk of pairs the narrowphase tests on the job system
+    std::vector<std::vector<PairContact>> contact_buffers;
+    ContactCache contacts;
+    std::vector<CollisionEvent> contact_exits;
+    TriggerIndex triggers;
+    // Entities tested against the triggers besides the local player, until they are removed
+    std::vector<Entity *> trigger_subscribers;
+    std::vector<std::pair<EntityId, SDL_Rect>> trigger_entities;
+    std::vector<TriggerContact> trigger_contacts;
+    TriggerCallback trigger_callback;
+    IntegrationBatch integration_batch;
+    std::vector<Handler *> parallel_handlers;
+    std::mutex dirty_transforms_mutex;
+    std::array<std::vector<Entity *>, DIRTY_SET_COUNT> dirty_transforms;
+    std::vector<Entity *> drained_transforms;
+    std::vector<std::pair<int, Render *>> render_queue;
     std::function<void(std::vector<Entity *> &)> callback;
 
     std::thread listener_thread;
@@ -96,7 +145,9 @@ class Engine {
     void CSClientReceiveBroadcastThread();
 
     Entity *CreateNewPlayer(int player_id, std::string player_address = "");
-    Entity *GetSpawnPoint(int index);
+    void RegisterPlayer(int player_id, Entity *player);
+    void UnregisterPlayer(Entity *entity);
+    bool GetSpawnPosition(int index, Position &position);
 
     void P2PHostListenerThread();
     void P2PHostBroadcastPlayers();
@@ -108,18 +159,41 @@ class Engine {
     void EncodeMessage(const EntityUpdate &entity_update, zmq::message_t &message);
     void DecodeMessage(const zmq::message_t &message, EntityUpdate &entity_update);
 
+    void InsertEntity(Entity *entity);
+    void EraseEntity(Entity *entity);
+    void AddToViews(Entity *entity);
+    void RemoveFromViews(Entity *entity);
+    std::vector<Entity *> &GetComponentView(ComponentMask mask);
+    void ApplyEntityCommands();
+    void PublishEntitySnapshot();
+
+    bool IsSimulatedLocally(Entity *entity, Entity *player);
     bool HandleQuitEvent();
     void GetTimeDelta();
+    int64_t GetStepTime();
+    void Simulate();
+    void SimulateStep();
+    void SavePreviousPoses();
+    void WaitForNextTick();
     void ApplyEntityPhysicsAndUpdates();
+    void IntegratePhysics(Entity *player);
+    void TakeDirtyTransforms(DirtySet set, std::vector<Entity *> &transforms);
+    void FlushDirtyTransforms();
     void TestCollision();
-    void ResetSideBoundaries();
-    void SetSideBoundaryVelocities(Velocity velocity);
+    void AddContact(const Collider &first, const Collider &second, const ContactManifold &manifold,
+                    bool raise_stay);
+    void TestTriggers();
+    void HandleTrigger(const Trigger &trigger, Entity *player, Overlap overlap);
+    void HandleSideBoundary(const Trigger &side_boundary, Entity *player, Overlap overlap);
     void Update();
-    void SetEntityTransforms();
     void RecordEvents();
     void HandleScaling();
     void RenderScene();
+    void ReclaimRemovedEntities();
+    void DropReclaimedDirtyTransforms(uint64_t safe_epoch);
+    void DestroyEntities();
     void RenderBackground();
+    void RenderTriggers();
     void RenderBorder();
     void CaptureTracyFrameImage();
     void Shutdown();
@@ -137,20 +211,52 @@ class Engine {
     void ToggleShowZoneBorders();
     void SetPlayerTextures(int player_textures);
     void SetMaxPlayers(int max_players);
+    void SetTickRate(int tick_rate);
+    void SetMaxSubsteps(int max_substeps);
+    void SetBroadphaseMode(BroadphaseMode mode);
+    void SetCollisionCellSize(int cell_size);
+    void SetLayersCollide(int layer_1, int layer_2, bool collide);
+    double GetInterpolationAlpha();
     void EngineTimelineChangeTic(double tic);
     double EngineTimelineGetTic();
     int64_t EngineTimelineGetTime();
     FrameTime EngineTimelineGetFrameTime();
     void EngineTimelineTogglePause();
     std::vector<Entity *> GetEntities();
+    const std::vector<Entity *> &GetLiveEntities();
+    const EntitySnapshot *GetEntitySnapshot();
+    Entity *FindEntity(std::string name);
+    void ReindexEntityName(Entity *entity);
     std::vector<Entity *> GetNetworkedEntities();
     void AddEntity(Entity *entity);
     void RemoveEntity(Entity *entity);
+    void RemoveEntity(EntityId entity_id);
+    void RefreshEntity(Entity *entity);
+    void AddDirtyTransform(Entity *entity, DirtyMask mask);
+    template <typename... Components> const std::vector<Entity *> &Query();
+    const std::vector<Entity *> &QueryComponents(ComponentMask mask);
+    const std::vector<Entity *> &QueryCategory(EntityCategory category);
+    int RegisterTag(std::string name);
+    const std::vector<Entity *> &QueryTag(int tag);
+    // Spatial queries over the boxes the last collision test left every entity in, on the layers
+    // in the mask. Results go into the caller's buffer, which is cleared first. Queries only read
+    // the colliders and keep their scratch per thread, so handlers that update in parallel can
+    // make them as well.
+    void QueryAABB(SDL_Rect box, CollisionMask mask, std::vector<Entity *> &results);
+    void QueryPoint(Position point, CollisionMask mask, std::vector<Entity *> &results);
+    // Hits are sorted nearest first
+    void Raycast(Position start, Position end, CollisionMask mask, std::vector<RaycastHit> &hits);
+    Entity *GetEntity(EntityId entity_id);
+    Entity *GetPlayer(int player_id);
+    Entity *GetLocalPlayer();
     void AddSideBoundary(Position position, Size size);
     void AddSpawnPoint(Position position, Size size);
     void AddDeathZone(Position position, Size size);
     void RespawnPlayer();
-    void HandleSideBoundaries(Entity *side_boundary);
+    void SubscribeToTriggers(Entity *entity);
+    void UnsubscribeFromTriggers(Entity *entity);
+    // Called when the local player or a subscribed entity enters or leaves a trigger
+    void SetTriggerCallback(TriggerCallback callback);
     void SetCallback(std::function<void(std::vector<Entity *> &)> callback);
 
     void BindPauseKey(SDL_Scancode key);
@@ -170,4 +276,10 @@ class Engine {
     void OnJoin(std::string player_address);
     void OnDiscover();
     void OnLeave();
-};
\ No newline at end of file
+};
+
+// Live entities that have every one of the given components. Like GetLiveEntities, the view is
+// only safe to use on the engine loop's thread.
+template <typename... Components> const std::vector<Entity *> &Engine::Query() {
+    return this->QueryComponents(ComponentMaskOf<Components...>());
+}
\ No newline at end of file
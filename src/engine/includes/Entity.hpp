@@ -2,29 +2,80 @@
 
 #include "App.hpp"
 #include "Component.hpp"
+#include "ComponentStorage.hpp"
 #include "Types.hpp"
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
-#include <typeindex>
-#include <unordered_map>
 
 extern App *app;
 
+// Each entity remembers its position in every engine view it is listed in: its category view, the
+// view of each of its tags and the view of each component mask it matches
+constexpr size_t CATEGORY_VIEW_SLOT = 0;
+constexpr size_t TAG_VIEW_SLOTS = CATEGORY_VIEW_SLOT + 1;
+constexpr size_t COMPONENT_VIEW_SLOTS = TAG_VIEW_SLOTS + MAX_TAGS;
+constexpr size_t VIEW_SLOT_COUNT = COMPONENT_VIEW_SLOTS + (size_t(1) << MAX_COMPONENTS);
+
+// Components are owned by their type's ComponentStorage, the entity only keeps track of its slots
+struct ComponentEntry {
+    size_t slot;
+    void (*release)(size_t slot);
+};
+
 class Entity {
   private:
     std::string name;
+    std::atomic<uint32_t> name_id;
     EntityCategory category;
-    std::unordered_map<std::type_index, std::unique_ptr<Component>> components;
+    EntityId id;
+    std::atomic<TagMask> tags;
+    // Tags the engine's tag views currently list the entity under, only used by the engine loop
+    TagMask indexed_tags;
+
+    // Position in the engine's live entity list, or -1 while the entity is not in the engine
+    std::atomic<int> engine_index;
+    // Positions in the engine's views, only used by the engine loop
+    std::array<int, VIEW_SLOT_COUNT> view_slots;
+
+    // Lookups read the component table without locking, while adding and removing components is
+    // serialized by components_mutex
+    std::array<std::atomic<Component *>, MAX_COMPONENTS> components;
+    std::array<ComponentEntry, MAX_COMPONENTS> component_entries;
     std::mutex components_mutex;
 
+    void ReleaseComponent(size_t type_id);
+    void RefreshViews();
+
   public:
     Entity(std::string name, EntityCategory category);
+    ~Entity();
+
+    // Entities are allocated from a pool, so despawned entities hand their memory to the next spawn
+    static void *operator new(size_t size);
+    static void operator delete(void *pointer, size_t size);
 
     std::string GetName();
+    uint32_t GetNameId();
     EntityCategory GetCategory();
+    EntityId GetId();
+    int GetEngineIndex();
+    bool IsInEngine();
+    ComponentMask GetComponentMask();
+    bool HasTag(int tag);
+    TagMask GetTags();
+    TagMask GetIndexedTags();
+    int GetViewSlot(size_t view);
 
     void SetName(std::string name);
+    void SetId(EntityId entity_id);
+    void SetEngineIndex(int engine_index);
+    void SetIndexedTags(TagMask indexed_tags);
+    void SetViewSlot(size_t view, int slot);
+    void AddTag(int tag);
+    void RemoveTag(int tag);
 
     template <typename T> void AddComponent();
     template <typename T> T *GetComponent();
@@ -32,20 +83,23 @@ class Entity {
 };
 
 template <typename T> void Entity::AddComponent() {
-    std::lock_guard<std::mutex> lock(components_mutex);
-    components[typeid(T)] = std::make_unique<T>(this);
+    std::lock_guard<std::mutex> lock(this->components_mutex);
+    this->ReleaseComponent(ComponentType<T>::ID);
+
+    size_t slot;
+    T *component = ComponentStorage<T>::GetInstance().Create(this, slot);
+    this->component_entries[ComponentType<T>::ID] =
+        ComponentEntry{slot, &ComponentStorage<T>::Release};
+    this->components[ComponentType<T>::ID].store(component, std::memory_order_release);
+    this->RefreshViews();
 }
 
 template <typename T> T *Entity::GetComponent() {
-    std::lock_guard<std::mutex> lock(components_mutex);
-    auto iterator = components.find(typeid(T));
-    if (iterator != components.end()) {
-        return dynamic_cast<T *>(iterator->second.get());
-    }
-    return nullptr;
+    return static_cast<T *>(this->components[ComponentType<T>::ID].load(std::memory_order_acquire));
 }
 
 template <typename T> void Entity::RemoveComponent() {
-    std::lock_guard<std::mutex> lock(components_mutex);
-    components.erase(typeid(T));
+    std::lock_guard<std::mutex> lock(this->components_mutex);
+    this->ReleaseComponent(ComponentType<T>::ID);
+    this->RefreshViews();
 }
\ No newline at end of file
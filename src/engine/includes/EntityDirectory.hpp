@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Types.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class Entity;
+
+// Resolves generational entity handles. Every entity gets a slot when it is constructed, and the
+// slot's generation is bumped when the entity is removed from the engine or destroyed, so a stale
+// handle resolves to nullptr instead of a dangling pointer. Resolving never takes a lock.
+class EntityDirectory {
+  public:
+    static EntityDirectory &GetInstance() {
+        static EntityDirectory instance;
+        return instance;
+    }
+
+    static constexpr size_t CHUNK_SIZE = 1024;
+    static constexpr size_t MAX_CHUNKS = 1024;
+
+  private:
+    EntityDirectory() {}
+    ~EntityDirectory();
+
+    struct Slot {
+        std::atomic<Entity *> entity{nullptr};
+        std::atomic<uint32_t> generation{1};
+    };
+
+    struct Chunk {
+        std::array<Slot, CHUNK_SIZE> slots;
+    };
+
+    std::mutex directory_mutex;
+    std::array<std::atomic<Chunk *>, MAX_CHUNKS> chunks{};
+    uint32_t slot_count = 0;
+    std::vector<uint32_t> free_slots;
+
+    Slot *GetSlot(uint32_t index);
+
+  public:
+    EntityDirectory(EntityDirectory const &) = delete;
+    void operator=(EntityDirectory const &) = delete;
+
+    EntityId Register(Entity *entity);
+    void Release(EntityId entity_id);
+    Entity *Resolve(EntityId entity_id);
+};
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Epoch-based reclamation for data that other threads read without locking. A reader pins the
+// current epoch for as long as it holds an EpochGuard, and the writer tags everything it retires
+// with the epoch returned by Advance. Retired data can be freed once its epoch is no newer than
+// GetSafeEpoch, which means that no reader pinned that epoch or an older one.
+class EpochManager {
+  public:
+    static EpochManager &GetInstance() {
+        static EpochManager instance;
+        return instance;
+    }
+
+    static constexpr size_t MAX_READERS = 256;
+
+  private:
+    EpochManager() {}
+
+    std::atomic<uint64_t> global_epoch{1};
+    // Epoch pinned by each reader thread, 0 while the thread is not reading
+    std::array<std::atomic<uint64_t>, MAX_READERS> reader_epochs{};
+    std::array<std::atomic<bool>, MAX_READERS> reader_slots_used{};
+    // Readers that did not get a slot of their own, nothing is freed while any of them is reading
+    std::atomic<int> overflow_readers{0};
+
+  public:
+    EpochManager(EpochManager const &) = delete;
+    void operator=(EpochManager const &) = delete;
+
+    int AcquireReaderSlot();
+    void ReleaseReaderSlot(int slot);
+    void Enter(int slot);
+    void Exit(int slot);
+
+    uint64_t Advance();
+    uint64_t GetSafeEpoch();
+};
+
+// Pins the current epoch on this thread. Guards nest, only the outermost one enters and exits.
+class EpochGuard {
+  public:
+    EpochGuard();
+    ~EpochGuard();
+
+    EpochGuard(EpochGuard const &) = delete;
+    void operator=(EpochGuard const &) = delete;
+};
\ No newline at end of file
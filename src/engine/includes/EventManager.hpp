@@ -35,12 +35,14 @@ class EventManager {
     void Register(std::vector<EventType> event_types, EventHandler *handler);
     void Deregister(std::vector<EventType> event_types, EventHandler *handler);
     void ProcessEvents();
+    bool HasHandlers(EventType event_type);
 
     void ProfileEventQueue();
     int64_t GetLastEventTimestamp();
 
     void RaiseInputEvent(InputEvent event);
     void RaiseCollisionEvent(CollisionEvent event);
+    void RaiseCollisionStayEvent(CollisionEvent event);
     void RaiseDeathEvent(DeathEvent event);
     void RaiseSpawnEvent(SpawnEvent event);
     void RaiseMoveEvent(MoveEvent event, bool ignore_change = false);
@@ -63,6 +65,7 @@ class EventManager {
 
     std::priority_queue<Event, std::vector<Event>, ComparePriority> GetEventQueue();
     std::unordered_map<EventType, std::unordered_set<EventHandler *>> GetHandlers();
+    bool HasStaleEntity(const Event &event);
     void HandleEvent(Event event);
     void HandleReplayedEvent(Event event);
     void PushEventQueue(Event event);
@@ -10,14 +10,24 @@ class Handler : public Component, public EventHandler {
     Entity *entity;
     std::function<void(Entity &)> update_callback;
     std::function<void(Entity &, Event &)> event_callback;
+    bool parallel_update;
+    bool collision_stay;
 
   public:
     Handler(Entity *entity);
+    ~Handler();
 
     std::function<void(Entity &)> GetUpdateCallback();
     void SetUpdateCallback(std::function<void(Entity &)> update_callback);
     // The callback references the function that makes the entity react to inputs
     void SetEventCallback(std::function<void(Entity &, Event &)> event_callback);
+    // Update callbacks that only touch their own entity can opt in to run on the job system
+    bool GetParallelUpdate();
+    void SetParallelUpdate(bool parallel_update);
+    // Collision events only mark where contacts start and end, handlers that need to hear about
+    // every step a contact lasts opt in to stay events
+    bool GetCollisionStay();
+    void SetCollisionStay(bool collision_stay);
 
     void Update() override;
     void OnEvent(Event event) override;
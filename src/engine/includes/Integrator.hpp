@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Types.hpp"
+#include <cstddef>
+
+using IntegrateKernel = void (*)(IntegrationBatch &batch, size_t begin, size_t end, float time);
+
+// Integrates batches of bodies with the widest vector kernel the CPU supports. The kernel is
+// picked once at startup, so the same binary runs on machines with and without AVX2.
+class Integrator {
+  public:
+    static Integrator &GetInstance() {
+        static Integrator instance;
+        return instance;
+    }
+
+  private:
+    Integrator();
+
+    IntegrateKernel kernel;
+    const char *kernel_name;
+
+  public:
+    Integrator(Integrator const &) = delete;
+    void operator=(Integrator const &) = delete;
+
+    const char *GetKernelName();
+    void Integrate(IntegrationBatch &batch, size_t begin, size_t end, float time);
+};
+
+void ClearIntegrationBatch(IntegrationBatch &batch);
+void AddToIntegrationBatch(IntegrationBatch &batch, Entity *entity, Position position,
+                           Velocity velocity, Acceleration acceleration);
\ No newline at end of file
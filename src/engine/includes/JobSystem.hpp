@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs independent ranges of work across a pool of worker threads. Every worker owns a deque of
+// jobs, takes its own work from the back and steals from the front of the other deques once it
+// runs dry, so uneven chunks still keep every core busy. The thread that submits work runs jobs
+// too while it waits for them to finish.
+class JobSystem {
+  public:
+    static JobSystem &GetInstance() {
+        static JobSystem instance;
+        return instance;
+    }
+
+  private:
+    JobSystem();
+    ~JobSystem();
+
+    struct Job {
+        const std::function<void(size_t, size_t)> *function;
+        size_t begin;
+        size_t end;
+        std::atomic<size_t> *remaining;
+    };
+
+    struct WorkerQueue {
+        std::mutex queue_mutex;
+        std::deque<Job> jobs;
+    };
+
+    // Queue 0 belongs to the threads that submit work, the rest to one worker each
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::atomic<size_t> pending_jobs{0};
+    std::atomic<bool> stopping{false};
+
+    void WorkerThread(size_t queue_index);
+    bool TryGetJob(size_t queue_index, Job &job);
+    void RunJob(const Job &job);
+
+  public:
+    JobSystem(JobSystem const &) = delete;
+    void operator=(JobSystem const &) = delete;
+
+    size_t GetWorkerCount();
+    // Splits [0, count) into chunks of chunk_size and calls function(begin, end) for each of them,
+    // returning once every chunk has run
+    void ParallelFor(size_t count, size_t chunk_size,
+                     const std::function<void(size_t, size_t)> &function);
+};
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Interns entity names. Every distinct name is stored once and gets a small numeric id, so lookups
+// by name hash the string once and the engine's name index only has to compare integers. Names are
+// reference counted by the entities that carry them, and the id of a name no entity uses any more
+// is handed to the next new name, so unique per-spawn names do not grow the table.
+class NameTable {
+  public:
+    static NameTable &GetInstance() {
+        static NameTable instance;
+        return instance;
+    }
+
+  private:
+    NameTable() {}
+
+    struct NameEntry {
+        std::string name;
+        uint32_t references;
+    };
+
+    std::mutex names_mutex;
+    std::unordered_map<std::string, uint32_t> name_ids;
+    std::vector<NameEntry> entries;
+    std::vector<uint32_t> free_ids;
+
+  public:
+    NameTable(NameTable const &) = delete;
+    void operator=(NameTable const &) = delete;
+
+    uint32_t Intern(const std::string &name);
+    void Release(uint32_t name_id);
+    bool Find(const std::string &name, uint32_t &name_id);
+};
\ No newline at end of file
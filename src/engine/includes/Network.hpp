@@ -14,6 +14,7 @@ class Network : public Component, public EventHandler {
 
   public:
     Network(Entity *entity);
+    ~Network();
 
     bool GetActive();
     std::string GetPlayerAddress();
@@ -23,6 +24,8 @@ class Network : public Component, public EventHandler {
     void SetPlayerAddress(std::string player_address);
     void SetOwner(NetworkRole owner);
 
+    void SendUpdate();
+
     void Update() override;
     void OnEvent(Event event) override;
 };
\ No newline at end of file
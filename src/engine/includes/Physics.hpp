@@ -21,6 +21,7 @@ class Physics : public Component {
     Velocity GetVelocity();
     Acceleration GetAcceleration();
     int64_t GetDelta();
+    bool HasMotion();
 
     void SetVelocity(Velocity velocity);
     void SetAcceleration(Acceleration acceleration);
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Fixed-size allocator for objects of type T. Blocks are carved out of chunks that are kept until
+// the pool is destroyed, and freed blocks are recycled through a free list, so spawning and
+// despawning at a steady rate does not go back to the heap.
+template <typename T> class Pool {
+  public:
+    static Pool &GetInstance() {
+        static Pool instance;
+        return instance;
+    }
+
+    static constexpr size_t CHUNK_SIZE = 256;
+
+  private:
+    Pool() {}
+    ~Pool() {
+        for (Block *chunk : this->chunks) {
+            delete[] chunk;
+        }
+    }
+
+    union Block {
+        Block *next;
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    std::mutex pool_mutex;
+    Block *free_list = nullptr;
+    std::vector<Block *> chunks;
+
+  public:
+    Pool(Pool const &) = delete;
+    void operator=(Pool const &) = delete;
+
+    void *Allocate();
+    void Deallocate(void *pointer);
+};
+
+template <typename T> void *Pool<T>::Allocate() {
+    std::lock_guard<std::mutex> lock(this->pool_mutex);
+
+    if (this->free_list == nullptr) {
+        Block *chunk = new Block[CHUNK_SIZE];
+        for (size_t i = 0; i < CHUNK_SIZE; i++) {
+            chunk[i].next = (i + 1 < CHUNK_SIZE) ? &chunk[i + 1] : nullptr;
+        }
+        this->chunks.push_back(chunk);
+        this->free_list = chunk;
+    }
+
+    Block *block = this->free_list;
+    this->free_list = block->next;
+    return block->data;
+}
+
+template <typename T> void Pool<T>::Deallocate(void *pointer) {
+    std::lock_guard<std::mutex> lock(this->pool_mutex);
+
+    Block *block = static_cast<Block *>(pointer);
+    block->next = this->free_list;
+    this->free_list = block;
+}
\ No newline at end of file
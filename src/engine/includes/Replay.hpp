@@ -37,14 +37,14 @@ class Replay : public EventHandler {
 
     std::mutex recorded_events_mutex;
     std::vector<Event> recorded_events;
-    std::vector<std::pair<Entity *, std::pair<Position, double>>> start_record_transforms;
-    std::vector<std::pair<Entity *, std::pair<Position, double>>> start_replay_transforms;
+    std::vector<std::pair<EntityId, std::pair<Position, double>>> start_record_transforms;
+    std::vector<std::pair<EntityId, std::pair<Position, double>>> start_replay_transforms;
 
     void HandleReplayInput(Event &event);
     void SetStartTransforms(
-        std::vector<std::pair<Entity *, std::pair<Position, double>>> &start_transforms);
+        std::vector<std::pair<EntityId, std::pair<Position, double>>> &start_transforms);
     void ApplyStartTransforms(
-        std::vector<std::pair<Entity *, std::pair<Position, double>>> &start_transforms);
+        std::vector<std::pair<EntityId, std::pair<Position, double>>> &start_transforms);
     void AdjustRecordedEventTimes();
     void RaiseRecordedEvents();
 
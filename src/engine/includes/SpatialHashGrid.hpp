@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Types.hpp"
+#include <SDL_rect.h>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Uniform grid broadphase. Boxes are bucketed into every square cell they cover, and only boxes
+// that share a cell and whose filters accept each other become candidate pairs, so the cost grows
+// with the number of nearby boxes instead of the square of all of them. The grid is rebuilt every
+// step, but keeps its buffers.
+class SpatialHashGrid {
+  private:
+    int cell_size;
+    std::vector<SDL_Rect> boxes;
+    std::vector<CollisionFilter> filters;
+    // One entry per covered cell, sorted so the boxes of a cell end up next to each other
+    std::vector<std::pair<uint64_t, uint32_t>> cell_entries;
+    // Boxes covering too many cells are kept out of the cells and tested against every box
+    std::vector<uint32_t> oversized;
+    // Extents of the boxes for the overlap kernel, and its hits for one oversized box
+    AabbBatch extents;
+    std::vector<uint64_t> oversized_hits;
+
+    uint64_t GetCellKey(int cell_x, int cell_y);
+
+  public:
+    SpatialHashGrid();
+
+    int GetCellSize();
+    void SetCellSize(int cell_size);
+
+    void Clear();
+    void Insert(SDL_Rect box, CollisionFilter filter);
+    void GetCandidatePairs(std::vector<std::pair<uint32_t, uint32_t>> &pairs);
+    void Query(SDL_Rect box, std::vector<uint32_t> &results);
+};
\ No newline at end of file
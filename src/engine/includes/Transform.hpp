@@ -4,30 +4,62 @@
 #include "Entity.hpp"
 #include "EventHandler.hpp"
 #include "Types.hpp"
-#include <mutex>
+#include <atomic>
+#include <cstdint>
 
 class Transform : public Component, public EventHandler {
   private:
     Entity *entity;
-    std::mutex position_mutex;
-    Position position;
+    // Position and angle are published together through a seqlock. A writer makes the sequence odd
+    // while it updates the fields, and readers retry until they see the same even sequence before
+    // and after reading, so a pose is never torn and reading it never takes a lock.
+    std::atomic<uint32_t> pose_sequence;
+    std::atomic<float> position_x;
+    std::atomic<float> position_y;
+    std::atomic<double> angle;
     Size size;
-    std::mutex angle_mutex;
-    double angle;
     SDL_Point anchor;
+    // Simulation steps since the transform last moved, it is asleep once this reaches SLEEP_STEPS
+    std::atomic<uint32_t> idle_steps;
+    // The pose before the last simulation step, only touched by the engine loop
+    Pose previous_pose;
+    bool previous_pose_saved;
+    // Dirty sets the transform is queued in, a write only queues it in the sets it is missing from
+    std::atomic<DirtyMask> dirty_sets;
+
+    uint32_t BeginPoseWrite();
+    void EndPoseWrite(uint32_t sequence);
+    void WritePose(Position position, double angle);
 
   public:
     Transform(Entity *entity);
+    ~Transform();
 
+    Pose GetPose();
+    Pose GetInterpolatedPose(double alpha);
     Position GetPosition();
     Size GetSize();
     double GetAngle();
     SDL_Point GetAnchor();
 
+    void SetPose(Position position, double angle);
     void SetPosition(Position position);
     void SetSize(Size size);
     void SetAngle(double angle);
     void SetAnchor(SDL_Point anchor);
+    void SavePreviousPose();
+    void Move(Position position, double angle);
+    void Move(Position position);
+    bool MoveUnmarked(Position position, double angle);
+    bool MoveUnmarked(Position position);
+    void MarkMoved();
+
+    void MarkDirty(DirtyMask mask);
+    void ClearDirty(DirtySet set);
+
+    bool IsSleeping();
+    void Wake();
+    void UpdateSleep(bool moving);
 
     void Update() override;
     void OnEvent(Event event) override;
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Types.hpp"
+#include <SDL_rect.h>
+#include <cstdint>
+#include <vector>
+
+// Zones the engine places for spawn points, death zones and side boundaries. They are not entities,
+// so they stay out of the entity list, the render sort, the physics batch and the broadphase, and
+// are only tested against the few entities that care about them.
+class TriggerIndex {
+  private:
+    std::vector<Trigger> triggers;
+    // Boxes of the triggers for the overlap kernel, moved along with the camera where needed
+    AabbBatch boxes;
+    std::vector<uint64_t> hits;
+    // Every overlap found by the last test and the one before it, sorted by entity and trigger
+    std::vector<TriggerOverlap> overlaps;
+    std::vector<TriggerOverlap> previous_overlaps;
+
+  public:
+    void Add(EntityCategory category, Position position, Size size, bool follows_camera);
+    const std::vector<Trigger> &GetTriggers();
+    const Trigger *Find(EntityCategory category, int index);
+    int GetCount(EntityCategory category);
+    SDL_Rect GetBox(const Trigger &trigger, Position camera_position);
+    // Tests every entity's box against every trigger. Overlaps are reported as entering or staying
+    // and overlaps of the last test that are gone as leaving.
+    void Test(const std::vector<std::pair<EntityId, SDL_Rect>> &entities, Position camera_position,
+              std::vector<TriggerContact> &contacts);
+    void Clear();
+};
\ No newline at end of file
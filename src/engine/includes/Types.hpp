@@ -2,8 +2,13 @@
 
 #include "SDL_scancode.h"
 #include <SDL_rect.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <unordered_map>
 #include <variant>
+#include <vector>
 
 class Entity;
 
@@ -17,12 +22,18 @@ enum class EntityCategory {
     SideBoundary,
     Camera
 };
+constexpr size_t ENTITY_CATEGORY_COUNT = size_t(EntityCategory::Camera) + 1;
+
+// Games can register up to MAX_TAGS tags, and every entity keeps its tags as one bit each
+constexpr size_t MAX_TAGS = 64;
+using TagMask = uint64_t;
 enum class LogLevel { Verbose = 1, Debug, Info, Warn, Error, Critical, Priorities };
 enum class NetworkMode { Single, ClientServer, PeerToPeer };
 enum class NetworkRole { Server, Client, Host, Peer };
 enum class Direction { Horizontal, Vertical };
 enum class Overlap { Left, Right, Top, Bottom, None };
 enum class Encoding { Struct, JSON };
+enum class EntityCommandType { Add, Remove, Refresh };
 
 struct Color {
     int red;
@@ -41,6 +52,11 @@ struct Position {
     float y;
 };
 
+struct Pose {
+    Position position;
+    double angle = 0;
+};
+
 struct Size {
     int width;
     int height;
@@ -68,6 +84,50 @@ struct FrameTime {
     int64_t delta;
 };
 
+// A tick rate of 0 steps the simulation once per rendered frame. Servers have nothing to render,
+// so they fall back to a fixed rate instead of spinning.
+constexpr int SERVER_TICK_RATE = 60;
+constexpr int DEFAULT_MAX_SUBSTEPS = 5;
+
+// Simulation steps a body has to go without moving before it falls asleep
+constexpr uint32_t SLEEP_STEPS = 30;
+
+// Bodies integrated and update callbacks run per job when work is spread across the job system
+constexpr size_t INTEGRATION_CHUNK_SIZE = 2048;
+constexpr size_t HANDLER_CHUNK_SIZE = 64;
+
+// Overlap kernels report one bit per tested pair or box, 64 to a word. Narrowphase chunks cover
+// whole words, so chunks tested concurrently never write the same word.
+constexpr size_t HIT_MASK_WORD_BITS = 64;
+constexpr size_t NARROWPHASE_CHUNK_SIZE = 4 * HIT_MASK_WORD_BITS;
+
+// Side of a collision grid cell in world units. Boxes covering more cells than the limit are
+// tested against every other box instead of being bucketed.
+constexpr int DEFAULT_COLLISION_CELL_SIZE = 128;
+constexpr size_t MAX_CELLS_PER_BOX = 64;
+
+// Every collider sits on one layer and only meets colliders on the layers in its mask, with the
+// engine's collision matrix able to turn off whole pairs of layers. Entities without a Collision
+// component sit on the default layer and accept every layer.
+constexpr size_t MAX_COLLISION_LAYERS = 32;
+constexpr int DEFAULT_COLLISION_LAYER = 0;
+using CollisionMask = uint32_t;
+constexpr CollisionMask ALL_COLLISION_LAYERS = ~CollisionMask(0);
+constexpr CollisionMask CollisionMaskOf(int layer) { return CollisionMask(1) << layer; }
+
+// Tree broadphase, stationary colliders live in a prebuilt tree and moving ones in a tree whose
+// leaves are fattened by the margin so small moves do not reinsert them
+enum class BroadphaseMode { Grid, Tree };
+constexpr uint32_t STATIC_TREE_LEAF_SIZE = 4;
+constexpr int AABB_TREE_MARGIN = 16;
+
+// Consumers of transform changes. Every write marks the transform in the sets it is not already
+// in, and each consumer drains its own set once per step or frame instead of scanning every entity.
+enum class DirtySet { Network, Replay, Render };
+constexpr size_t DIRTY_SET_COUNT = size_t(DirtySet::Render) + 1;
+using DirtyMask = uint8_t;
+constexpr DirtyMask DirtyMaskOf(DirtySet set) { return DirtyMask(1) << size_t(set); }
+
 struct NetworkInfo {
     NetworkMode mode;
     NetworkRole role;
@@ -77,6 +137,90 @@ struct NetworkInfo {
     std::string peer_ip;
 };
 
+// Generational handle to an entity. The generation is bumped whenever the entity leaves the engine,
+// so a handle kept around in a queued or recorded event can be told apart from a live one
+struct EntityId {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool operator==(const EntityId &other) const {
+        return this->index == other.index && this->generation == other.generation;
+    }
+    bool operator!=(const EntityId &other) const { return !(*this == other); }
+};
+
+struct EntityIdHash {
+    size_t operator()(const EntityId &entity_id) const {
+        return std::hash<uint64_t>()((static_cast<uint64_t>(entity_id.generation) << 32) |
+                                     entity_id.index);
+    }
+};
+
+struct EntityCommand {
+    EntityCommandType type;
+    Entity *entity;
+};
+
+// Immutable copy of the engine's entity lists, published for threads outside the engine loop.
+// entity_names holds one (name id, entity) pair per entity, sorted by name id.
+struct EntitySnapshot {
+    std::vector<Entity *> entities;
+    std::vector<Entity *> networked_entities;
+    std::vector<std::pair<uint32_t, Entity *>> entity_names;
+};
+
+// Everything that decides whether two colliders may meet at all, so the broadphase can reject a
+// pair before it compares their boxes
+struct CollisionFilter {
+    CollisionMask layer;
+    CollisionMask mask;
+    bool body;
+    bool zone;
+    bool player;
+    bool controllable;
+};
+
+struct Collider {
+    Entity *entity;
+    // Spatial queries run between collision tests, when the entity may already have been removed
+    EntityId id;
+    SDL_Rect rect;
+    CollisionFilter filter;
+    bool sleeping;
+    // Continuous colliders are also swept from start_rect by displacement to the position the
+    // integrator left them at, and remember the earliest body they hit along the way
+    bool swept;
+    SDL_Rect start_rect;
+    Position position;
+    Position displacement;
+    float time_of_impact;
+    const Collider *first_hit;
+};
+
+// Bodies integrated together by the physics stage, with one array per field so the integrator can
+// run vector kernels over them. Index i of every array belongs to entities[i].
+struct IntegrationBatch {
+    std::vector<Entity *> entities;
+    std::vector<float> position_x;
+    std::vector<float> position_y;
+    std::vector<float> velocity_x;
+    std::vector<float> velocity_y;
+    std::vector<float> acceleration_x;
+    std::vector<float> acceleration_y;
+    // Set for the bodies whose position changed, bytes so chunks can be written concurrently
+    std::vector<uint8_t> moved;
+};
+
+// Boxes tested by the overlap kernels, with one array per extent so several boxes are compared at
+// once. Box i spans [min_x[i], max_x[i]) by [min_y[i], max_y[i]), and empty boxes are stored
+// inside out so they never overlap anything.
+struct AabbBatch {
+    std::vector<int32_t> min_x;
+    std::vector<int32_t> min_y;
+    std::vector<int32_t> max_x;
+    std::vector<int32_t> max_y;
+};
+
 struct JoinReply {
     int player_id;
 };
@@ -94,6 +238,7 @@ enum class EventType {
     Move,
     SendUpdate,
     Collision,
+    CollisionStay,
     Spawn,
     Death,
     Join,
@@ -114,27 +259,93 @@ struct InputEvent {
     bool pressed;
 };
 
+// Collision events are raised when a pair starts touching and when it stops. Stay events are
+// raised every step in between, but only to handlers that subscribed to them.
+enum class ContactPhase { Enter, Stay, Exit };
+
+// How two overlapping boxes touch, seen from the first one. The side is the side of the second
+// box the first one touches, the normal points from the first box to the second one, and the depth
+// is how far they overlap along it.
+struct ContactManifold {
+    Overlap side = Overlap::None;
+    int depth = 0;
+    Position normal = {0, 0};
+};
+
+// A contact that ended because one of its entities was removed still exits. The removed entity's
+// handle no longer resolves by then, so handlers of exit events have to accept a missing partner.
 struct CollisionEvent {
-    Entity *collider_1;
-    Entity *collider_2;
+    EntityId collider_1;
+    EntityId collider_2;
+    ContactPhase phase = ContactPhase::Enter;
+    ContactManifold manifold;
 };
 
-struct DeathEvent {
+// What the narrowphase found for a candidate pair. Touching pairs are ordered the way the contact
+// cache keeps them, swept pairs keep their collider order.
+enum class PairResult { Touching, Swept };
+
+struct PairContact {
+    uint32_t collider_1;
+    uint32_t collider_2;
+    PairResult result;
+    ContactManifold manifold;
+    float time_of_impact;
+};
+
+// Where a ray cast enters an entity's box, as a fraction of the way from its start to its end
+struct RaycastHit {
     Entity *entity;
+    Position point;
+    Position normal;
+    float fraction;
+};
+
+// Zone placed by the engine for spawning, dying or scrolling the camera. Triggers that follow the
+// camera are placed relative to it, so they keep their place on screen as it scrolls. The index
+// counts the triggers of the same category in the order they were added.
+struct Trigger {
+    EntityCategory category;
+    int index;
+    Position position;
+    Size size;
+    bool follows_camera;
+};
+
+// An entity's box overlapping a trigger, with the side of the entity the trigger touches
+struct TriggerOverlap {
+    uint64_t entity;
+    uint32_t trigger;
+    ContactManifold manifold;
+};
+
+// An entity entering, staying in or leaving a trigger, by the trigger's place in the index. Leaving
+// contacts keep the manifold of the last overlap.
+struct TriggerContact {
+    EntityId entity;
+    uint32_t trigger;
+    ContactPhase phase;
+    ContactManifold manifold;
+};
+
+using TriggerCallback = std::function<void(Entity *, const Trigger &, ContactPhase)>;
+
+struct DeathEvent {
+    EntityId entity;
 };
 
 struct SpawnEvent {
-    Entity *entity;
+    EntityId entity;
 };
 
 struct MoveEvent {
-    Entity *entity;
+    EntityId entity;
     Position position;
     double angle = 0;
 };
 
 struct SendUpdateEvent {
-    Entity *entity;
+    EntityId entity;
 };
 
 struct JoinEvent {
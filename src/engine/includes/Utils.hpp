@@ -14,12 +14,16 @@ std::string GetAssetPath(const std::string &path);
 void Log(LogLevel log_level, const char *fmt, ...);
 Size GetWindowSize();
 Overlap GetOverlap(SDL_Rect rect_1, SDL_Rect rect_2);
-Entity *GetEntityByName(std::string name, std::vector<Entity *> entities);
-Entity *GetControllable(std::vector<Entity *> entities);
-int GetControllableCount(std::vector<Entity *> entities);
-std::vector<Entity *> GetEntitiesByRole(NetworkInfo network_info, std::vector<Entity *> entities);
+ContactManifold GetContactManifold(SDL_Rect rect_1, SDL_Rect rect_2);
+ContactManifold FlipManifold(const ContactManifold &manifold);
+bool GetTimeOfImpact(SDL_Rect moving, Position displacement, SDL_Rect target,
+                     float &time_of_impact);
+Entity *GetEntityByName(std::string name, const std::vector<Entity *> &entities);
+Entity *GetControllable(const std::vector<Entity *> &entities);
+int GetControllableCount(const std::vector<Entity *> &entities);
+std::vector<Entity *> GetEntitiesByRole(NetworkInfo network_info,
+                                        const std::vector<Entity *> &entities);
 void SetPlayerTexture(Entity *controllable, int player_id, int player_textures);
-Entity *GetClientPlayer(int player_id, std::vector<Entity *> entities);
 bool SetEngineCLIOptions(int argc, char *args[]);
 std::string GetConnectionAddress(std::string address, int port);
 void HandleSIGINT(int signum);
@@ -27,6 +31,7 @@ Position GetScreenPosition(Position world_position, Position camera_position);
 int GetPlayerIdFromName(std::string player_name);
 std::vector<std::string> Split(std::string str, char delimiter);
 bool IsZoneCategory(EntityCategory category);
-std::vector<Entity *> GetEntitiesByCategory(std::vector<Entity *> entities,
+bool CanCollide(const CollisionFilter &filter_1, const CollisionFilter &filter_2);
+std::vector<Entity *> GetEntitiesByCategory(const std::vector<Entity *> &entities,
                                             EntityCategory category);
 int GetRandomInt(int n);
\ No newline at end of file
@@ -105,15 +105,15 @@ void HandleAlienInput(Entity &alien, Event &event) {
 
 void HandleAlienCollision(Entity &alien, Event &event) {
     CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
-    if (collision_event == nullptr) {
+    if (collision_event == nullptr || collision_event->phase != ContactPhase::Enter) {
         return;
     }
 
     Entity *collider = nullptr;
-    if (alien.GetName() == collision_event->collider_1->GetName()) {
-        collider = collision_event->collider_2;
-    } else if (alien.GetName() == collision_event->collider_2->GetName()) {
-        collider = collision_event->collider_1;
+    if (alien.GetId() == collision_event->collider_1) {
+        collider = Engine::GetInstance().GetEntity(collision_event->collider_2);
+    } else if (alien.GetId() == collision_event->collider_2) {
+        collider = Engine::GetInstance().GetEntity(collision_event->collider_1);
     }
     if (collider == nullptr) {
         return;
@@ -439,12 +439,6 @@ void CreateDeathZones() {
         Size{window_size.width * 4, 10});
 }
 
-void DestroyEntities(std::vector<Entity *> entities) {
-    for (Entity *entity : entities) {
-        delete entity;
-    }
-}
-
 void BindEngineInputs() {
     Engine::GetInstance().BindPauseKey(SDL_SCANCODE_P);
     Engine::GetInstance().BindSpeedDownKey(SDL_SCANCODE_COMMA);
@@ -497,6 +491,5 @@ int main(int argc, char *args[]) {
 
     Engine::GetInstance().Start();
     Log(LogLevel::Info, "The game engine has closed the game cleanly");
-    DestroyEntities(entities);
     return 0;
 }
\ No newline at end of file
@@ -442,12 +442,6 @@ void AddObjectsToEngine(std::vector<Entity *> entities) {
     }
 }
 
-void DestroyEntities(std::vector<Entity *> entities) {
-    for (Entity *entity : entities) {
-        delete entity;
-    }
-}
-
 int main(int argc, char *args[]) {
     std::string game_title = "Mitesh's CSC581 HW3 Game: Platformer";
     int max_player_count = 100, texture_count = 4;
@@ -481,8 +475,5 @@ int main(int argc, char *args[]) {
     // The Start function keeps running until an "exit event occurs"
     Engine::GetInstance().Start();
     Log(LogLevel::Info, "The game engine has closed the game cleanly");
-
-    // Add Game Cleanup code (deallocating pointers)
-    DestroyEntities(entities);
     return 0;
 }
\ No newline at end of file
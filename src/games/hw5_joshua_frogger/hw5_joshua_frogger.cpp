@@ -24,13 +24,15 @@ std::vector<Entity *> river_bodies;
 
 Size window_size;
 NetworkInfo network_info;
+int bush_tag = -1;
+int home_tag = -1;
+int floater_tag = -1;
 
 void Update(std::vector<Entity *> &entities) {}
 
 void SetRiverBodies(std::vector<Entity *> &entities) {
     for (const auto &entity : entities) {
-        if (entity->GetName().find("bush") == 0 || entity->GetName().find("home") == 0 ||
-            entity->GetName().find("turtle") == 0 || entity->GetName().find("log") == 0) {
+        if (entity->HasTag(bush_tag) || entity->HasTag(home_tag) || entity->HasTag(floater_tag)) {
             river_bodies.push_back(entity);
         }
     }
@@ -65,9 +67,9 @@ Entity *GetOverlappingRiverBody(Entity &frog, Position &position) {
 
 void MoveFrog(Entity &frog, Position &position) {
     if (position.y < tile_0.y - (TILE_SIZE * 12)) {
-        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{&frog});
+        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{frog.GetId()});
     }
-    EventManager::GetInstance().RaiseMoveEvent(MoveEvent{&frog, position});
+    EventManager::GetInstance().RaiseMoveEvent(MoveEvent{frog.GetId(), position});
 
     if (position.y >= tile_0.y - (TILE_SIZE * 6)) {
         return;
@@ -75,25 +77,24 @@ void MoveFrog(Entity &frog, Position &position) {
 
     Entity *overlapping_river_body = GetOverlappingRiverBody(frog, position);
     if (overlapping_river_body == nullptr) {
-        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{&frog});
+        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{frog.GetId()});
         return;
     }
-    if (overlapping_river_body->GetName().find("bush") == 0) {
-        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{&frog});
+    if (overlapping_river_body->HasTag(bush_tag)) {
+        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{frog.GetId()});
         return;
     }
 
-    if ((overlapping_river_body->GetName().find("turtle") == 0) ||
-        (overlapping_river_body->GetName().find("log") == 0)) {
+    if (overlapping_river_body->HasTag(floater_tag)) {
         frog.GetComponent<Physics>()->SetVelocity(
             overlapping_river_body->GetComponent<Physics>()->GetVelocity());
     }
-    if (overlapping_river_body->GetName().find("home") == 0) {
+    if (overlapping_river_body->HasTag(home_tag)) {
         if (overlapping_river_body->GetComponent<Render>()->GetTexturePath() == "") {
             filled_homes += 1;
             overlapping_river_body->GetComponent<Render>()->SetTexture("frog_home.png");
         }
-        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{&frog});
+        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{frog.GetId()});
 
         if (filled_homes == 5) {
             Log(LogLevel::Info, "");
@@ -215,7 +216,7 @@ void UpdateFrog(Entity &frog) {
     }
 
     if (frog_out_left || frog_out_right) {
-        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{&frog});
+        EventManager::GetInstance().RaiseDeathEvent(DeathEvent{frog.GetId()});
     }
 }
 
@@ -233,11 +234,11 @@ void UpdateVehicle(Entity &vehicle) {
 
     if (vehicle_out_left) {
         new_pos.x = map_right_edge;
-        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{&vehicle, new_pos});
+        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{vehicle.GetId(), new_pos});
     }
     if (vehicle_out_right) {
         new_pos.x = map_left_edge - TILE_SIZE;
-        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{&vehicle, new_pos});
+        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{vehicle.GetId(), new_pos});
     }
 }
 
@@ -350,6 +351,7 @@ void CreateFloaters(std::vector<Entity *> &entities) {
             floater->AddComponent<Handler>();
             floater->AddComponent<Render>();
             floater->AddComponent<Network>();
+            floater->AddTag(floater_tag);
 
             floater->GetComponent<Transform>()->SetPosition(floater_position);
             floater->GetComponent<Transform>()->SetSize(
@@ -433,6 +435,11 @@ void CreateMap(std::vector<Entity *> &entities) {
             tile->AddComponent<Render>();
             tile->AddComponent<Transform>();
             tile->AddComponent<Network>();
+            if (tile_name == "bush") {
+                tile->AddTag(bush_tag);
+            } else if (tile_name == "home") {
+                tile->AddTag(home_tag);
+            }
 
             tile->GetComponent<Transform>()->SetPosition(tile_position);
             tile->GetComponent<Transform>()->SetSize(tile_size);
@@ -504,12 +511,6 @@ void CreateDeathZones() {
         Size{window_size.width * 3, thickness});
 }
 
-void DestroyEntities(std::vector<Entity *> entities) {
-    for (Entity *entity : entities) {
-        delete entity;
-    }
-}
-
 void BindEngineInputs() {
     Engine::GetInstance().BindPauseKey(SDL_SCANCODE_P);
     Engine::GetInstance().BindSpeedDownKey(SDL_SCANCODE_COMMA);
@@ -548,6 +549,9 @@ int main(int argc, char *args[]) {
     RegisterInputChords();
     network_info = Engine::GetInstance().GetNetworkInfo();
     window_size = GetWindowSize();
+    bush_tag = Engine::GetInstance().RegisterTag("bush");
+    home_tag = Engine::GetInstance().RegisterTag("home");
+    floater_tag = Engine::GetInstance().RegisterTag("floater");
     tile_0.x = float((window_size.width / 2.0) - ((TILE_SIZE * COLUMNS) / 2.0));
     tile_0.y = float((window_size.height / 2.0) + (((ROWS / 2.0) - 1) * TILE_SIZE));
 
@@ -566,6 +570,5 @@ int main(int argc, char *args[]) {
 
     Engine::GetInstance().Start();
     Log(LogLevel::Info, "The game engine has closed the game cleanly");
-    DestroyEntities(entities);
     return 0;
 }
\ No newline at end of file
@@ -15,6 +15,7 @@
 const int TILE_SIZE = 100;
 Size window_size;
 NetworkInfo network_info;
+int house_tag = -1;
 std::vector<const char *> enemy_textures =
     std::vector({"ladybug.png", "mouse.png", "worm.png", "bee.png"});
 
@@ -107,21 +108,21 @@ void HandleAlienInput(Entity &alien, Event &event) {
 
 void HandleAlienCollision(Entity &alien, Event &event) {
     CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
-    if (collision_event == nullptr) {
+    if (collision_event == nullptr || collision_event->phase != ContactPhase::Enter) {
         return;
     }
 
     Entity *collider = nullptr;
-    if (alien.GetName() == collision_event->collider_1->GetName()) {
-        collider = collision_event->collider_2;
-    } else if (alien.GetName() == collision_event->collider_2->GetName()) {
-        collider = collision_event->collider_1;
+    if (alien.GetId() == collision_event->collider_1) {
+        collider = Engine::GetInstance().GetEntity(collision_event->collider_2);
+    } else if (alien.GetId() == collision_event->collider_2) {
+        collider = Engine::GetInstance().GetEntity(collision_event->collider_1);
     }
     if (collider == nullptr) {
         return;
     }
 
-    if (collider->GetName().find("house") == 0) {
+    if (collider->HasTag(house_tag)) {
         Log(LogLevel::Info, "");
         Log(LogLevel::Info, "You made it home!");
         Log(LogLevel::Info, "");
@@ -247,6 +248,7 @@ Entity *CreatePlatform() {
     platform->GetComponent<Transform>()->SetSize(Size{TILE_SIZE * 3, TILE_SIZE / 2});
     platform->GetComponent<Physics>()->SetVelocity(Velocity{40, 0});
     platform->GetComponent<Handler>()->SetUpdateCallback(UpdatePlatform);
+    platform->GetComponent<Handler>()->SetParallelUpdate(true);
     platform->GetComponent<Network>()->SetOwner(NetworkRole::Server);
     return platform;
 }
@@ -256,6 +258,7 @@ Entity *CreateHouse() {
     house->AddComponent<Render>();
     house->AddComponent<Transform>();
     house->AddComponent<Network>();
+    house->AddTag(house_tag);
 
     Size house_size = Size{241, 217};
     house_size.height *= 2;
@@ -374,6 +377,7 @@ std::vector<Entity *> CreateEnemies() {
         enemy->GetComponent<Transform>()->SetSize(Size{TILE_SIZE, TILE_SIZE});
         enemy->GetComponent<Physics>()->SetVelocity(Velocity{0, vel_y});
         enemy->GetComponent<Handler>()->SetUpdateCallback(UpdateEnemy);
+        enemy->GetComponent<Handler>()->SetParallelUpdate(true);
         enemy->GetComponent<Render>()->SetColor(Color{0, 0, 0, 0});
         enemy->GetComponent<Render>()->SetTexture(
             enemy_textures[enemy_index % enemy_textures.size()]);
@@ -449,12 +453,6 @@ void CreateDeathZones() {
         Size{window_size.width * 4, 10});
 }
 
-void DestroyEntities(std::vector<Entity *> entities) {
-    for (Entity *entity : entities) {
-        delete entity;
-    }
-}
-
 void BindEngineInputs() {
     Engine::GetInstance().BindPauseKey(SDL_SCANCODE_P);
     Engine::GetInstance().BindSpeedDownKey(SDL_SCANCODE_COMMA);
@@ -494,6 +492,7 @@ int main(int argc, char *args[]) {
     RegisterInputChords();
     network_info = Engine::GetInstance().GetNetworkInfo();
     window_size = GetWindowSize();
+    house_tag = Engine::GetInstance().RegisterTag("house");
 
     CreateSideBoundaries();
     CreateSpawnPoints();
@@ -509,6 +508,5 @@ int main(int argc, char *args[]) {
 
     Engine::GetInstance().Start();
     Log(LogLevel::Info, "The game engine has closed the game cleanly");
-    DestroyEntities(entities);
     return 0;
 }
\ No newline at end of file
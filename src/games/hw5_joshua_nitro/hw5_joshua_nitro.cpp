@@ -31,6 +31,8 @@ std::vector<std::pair<const char *, Size>> obstacle_textures = {{"barrel_1.png",
 Color background_color = Color{166, 201, 203, 255};
 Size window_size;
 NetworkInfo network_info;
+int obstacle_tag = -1;
+int track_tag = -1;
 
 struct KeyState {
     bool up;
@@ -52,10 +54,9 @@ struct PowerTime {
 
 void Update(std::vector<Entity *> &entities) {
     std::vector<Entity *> outside_obstacles;
-    for (const auto &entity : entities) {
-        if (entity->GetName().find("obstacle") == 0 &&
-            entity->GetComponent<Transform>()->GetPosition().x ==
-                -float(entity->GetComponent<Transform>()->GetSize().width)) {
+    for (Entity *entity : Engine::GetInstance().QueryTag(obstacle_tag)) {
+        if (entity->GetComponent<Transform>()->GetPosition().x ==
+            -float(entity->GetComponent<Transform>()->GetSize().width)) {
             outside_obstacles.push_back(entity);
         }
     }
@@ -83,17 +84,16 @@ void Update(std::vector<Entity *> &entities) {
         random_obstacle_pos.y =
             -float(random_obstacle->GetComponent<Transform>()->GetSize().height);
 
-        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{random_obstacle, random_obstacle_pos});
+        EventManager::GetInstance().RaiseMoveEvent(
+            MoveEvent{random_obstacle->GetId(), random_obstacle_pos});
     }
 
     float highest_track_y = std::numeric_limits<float>::max();
-    for (const auto &entity : entities) {
-        if (entity->GetName().find("track") == 0) {
-            float track_y = entity->GetComponent<Transform>()->GetPosition().y;
-            if (track_y < highest_track_y) {
-                highest_track = entity;
-                highest_track_y = track_y;
-            }
+    for (Entity *entity : Engine::GetInstance().QueryTag(track_tag)) {
+        float track_y = entity->GetComponent<Transform>()->GetPosition().y;
+        if (track_y < highest_track_y) {
+            highest_track = entity;
+            highest_track_y = track_y;
         }
     }
 }
@@ -279,7 +279,7 @@ void UpdateObstacle(Entity &obstacle) {
     if (obstacle_out_bottom) {
         Position new_pos = Position{-float(obstacle.GetComponent<Transform>()->GetSize().width),
                                     -float(obstacle.GetComponent<Transform>()->GetSize().height)};
-        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{&obstacle, new_pos});
+        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{obstacle.GetId(), new_pos});
     }
 }
 
@@ -292,7 +292,7 @@ void UpdateRaceTrack(Entity &track) {
         Position new_pos = Position{highest_track->GetComponent<Transform>()->GetPosition().x,
                                     highest_track->GetComponent<Transform>()->GetPosition().y -
                                         float(racetrack_size.height)};
-        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{&track, new_pos});
+        EventManager::GetInstance().RaiseMoveEvent(MoveEvent{track.GetId(), new_pos});
     }
 }
 
@@ -329,6 +329,7 @@ void CreateObstacles(std::vector<Entity *> &entities) {
         obstacle->AddComponent<Handler>();
         obstacle->AddComponent<Render>();
         obstacle->AddComponent<Network>();
+        obstacle->AddTag(obstacle_tag);
 
         obstacle->GetComponent<Transform>()->SetPosition(
             Position{-float(size.width), -float(size.height)});
@@ -356,6 +357,7 @@ void CreateRaceTrack(std::vector<Entity *> &entities) {
         track->AddComponent<Handler>();
         track->AddComponent<Render>();
         track->AddComponent<Network>();
+        track->AddTag(track_tag);
 
         track->GetComponent<Transform>()->SetPosition(Position{
             0, -float(racetrack_size.height) + float(track_index * racetrack_size.height)});
@@ -420,12 +422,6 @@ void CreateDeathZones() {
         Size{window_size.width * 7, 10});
 }
 
-void DestroyEntities(std::vector<Entity *> entities) {
-    for (Entity *entity : entities) {
-        delete entity;
-    }
-}
-
 void BindEngineInputs() {
     Engine::GetInstance().BindPauseKey(SDL_SCANCODE_P);
     Engine::GetInstance().BindSpeedDownKey(SDL_SCANCODE_COMMA);
@@ -464,6 +460,8 @@ int main(int argc, char *args[]) {
     RegisterInputChords();
     network_info = Engine::GetInstance().GetNetworkInfo();
     window_size = GetWindowSize();
+    obstacle_tag = Engine::GetInstance().RegisterTag("obstacle");
+    track_tag = Engine::GetInstance().RegisterTag("track");
 
     CreateSpawnPoints();
     CreateDeathZones();
@@ -478,6 +476,5 @@ int main(int argc, char *args[]) {
 
     Engine::GetInstance().Start();
     Log(LogLevel::Info, "The game engine has closed the game cleanly");
-    DestroyEntities(entities);
     return 0;
 }
\ No newline at end of file
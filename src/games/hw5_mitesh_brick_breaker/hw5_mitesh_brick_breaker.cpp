@@ -16,6 +16,7 @@
 
 NetworkInfo network_info;
 Size window_size;
+int brick_tag = -1;
 
 struct GunEvent {
     bool move_left;
@@ -23,13 +24,7 @@ struct GunEvent {
 } platform_event;
 
 void Update(std::vector<Entity *> &entities) {
-    bool brick_found = false;
-    for (Entity *entity : entities) {
-        if (entity->GetName().substr(0, 5) == "brick") {
-            brick_found = true;
-            break;
-        }
-    }
+    bool brick_found = !Engine::GetInstance().QueryTag(brick_tag).empty();
 
     if (!brick_found) {
         Log(LogLevel::Info, "All bricks are destroyed. You win!");
@@ -52,8 +47,9 @@ void UpdatePlatform(Entity &platform) {
 void HandleBrickEvent(Entity &brick, Event &event) {
     CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
 
-    if (collision_event) {
-        if (collision_event->collider_1 == &brick || collision_event->collider_2 == &brick) {
+    if (collision_event && collision_event->phase == ContactPhase::Enter) {
+        if (collision_event->collider_1 == brick.GetId() ||
+            collision_event->collider_2 == brick.GetId()) {
             Engine::GetInstance().RemoveEntity(&brick);
         }
     }
@@ -191,6 +187,7 @@ std::vector<Entity *> CreateBricks() {
         brick->AddComponent<Collision>();
         brick->AddComponent<Network>();
         brick->AddComponent<Handler>();
+        brick->AddTag(brick_tag);
 
         brick->GetComponent<Transform>()->SetPosition({float(190 + 160 * number_of_bricks), 220});
         brick->GetComponent<Transform>()->SetSize({150, 50});
@@ -210,6 +207,7 @@ std::vector<Entity *> CreateBricks() {
         brick->AddComponent<Collision>();
         brick->AddComponent<Network>();
         brick->AddComponent<Handler>();
+        brick->AddTag(brick_tag);
 
         brick->GetComponent<Transform>()->SetPosition(
             {float(190 + 160 * (number_of_bricks - 10)), 150});
@@ -230,6 +228,7 @@ std::vector<Entity *> CreateBricks() {
         brick->AddComponent<Collision>();
         brick->AddComponent<Network>();
         brick->AddComponent<Handler>();
+        brick->AddTag(brick_tag);
 
         brick->GetComponent<Transform>()->SetPosition(
             {float(190 + 160 * (number_of_bricks - 20)), 80});
@@ -301,12 +300,6 @@ void AddObjectsToEngine(std::vector<Entity *> entities) {
     }
 }
 
-void DestroyEntities(std::vector<Entity *> entities) {
-    for (Entity *entity : entities) {
-        delete entity;
-    }
-}
-
 int main(int argc, char *args[]) {
     std::string game_title = "Mitesh's CSC581 HW5 Game: Brick Breaker";
     int max_player_count = 100, texture_count = 4;
@@ -332,6 +325,7 @@ int main(int argc, char *args[]) {
     network_info = Engine::GetInstance().GetNetworkInfo();
 
     window_size = GetWindowSize();
+    brick_tag = Engine::GetInstance().RegisterTag("brick");
 
     std::vector<Entity *> entities = CreateEntities();
     AddObjectsToEngine(entities);
@@ -340,8 +334,5 @@ int main(int argc, char *args[]) {
     // The Start function keeps running until an "exit event occurs"
     Engine::GetInstance().Start();
     Log(LogLevel::Info, "The game engine has closed the game cleanly");
-
-    // Add Game Cleanup code (deallocating pointers)
-    DestroyEntities(entities);
     return 0;
 }
\ No newline at end of file
@@ -17,10 +17,11 @@
 NetworkInfo network_info;
 Size window_size;
 const int ROWS = 2, COLUMNS = 27, BUBBLE_SIZE = 70;
+const int BUBBLE_LAYER = 1;
 const float TIME_TO_MOVE_DOWN = 15.0f;
 std::chrono::steady_clock::time_point last_move_down = std::chrono::steady_clock::now();
 std::chrono::steady_clock::time_point last_update_time = std::chrono::steady_clock::now();
-std::vector<Entity *> bubbles;
+std::vector<EntityId> bubbles;
 int64_t last_bullet_fired_time = 0;
 
 struct GunEvent {
@@ -35,7 +36,13 @@ void MoveBubblesDown() {
     float elapsed_time = std::chrono::duration<float>(now - last_move_down).count();
 
     if (elapsed_time >= TIME_TO_MOVE_DOWN) {
-        for (Entity *bubble : bubbles) {
+        for (EntityId bubble_id : bubbles) {
+            // Popped bubbles are destroyed by the engine, their handles no longer resolve
+            Entity *bubble = Engine::GetInstance().GetEntity(bubble_id);
+            if (bubble == nullptr) {
+                continue;
+            }
+
             Transform *transform = bubble->GetComponent<Transform>();
             Position current_pos = transform->GetPosition();
             transform->SetPosition({current_pos.x, current_pos.y + BUBBLE_SIZE});
@@ -53,21 +60,34 @@ void MoveBubblesDown() {
 
 void Update(std::vector<Entity *> &entities) { MoveBubblesDown(); }
 
-void UpdateBullet(Entity &bullet) { bullet.GetComponent<Physics>()->SetVelocity({0, -10}); }
+void UpdateBullet(Entity &bullet) {
+    bullet.GetComponent<Physics>()->SetVelocity({0, -10});
+
+    // A bullet that missed every bubble is removed once it has left the top of the window
+    Transform *transform = bullet.GetComponent<Transform>();
+    if (transform->GetPosition().y + float(transform->GetSize().height) < 0) {
+        Engine::GetInstance().RemoveEntity(&bullet);
+    }
+}
 
 void UpdateBubble(Entity &bubble) { bubble.GetComponent<Physics>()->SetVelocity({0, 0}); }
 
 void HandleBulletEvent(Entity &bullet, Event &event) {
     CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
 
-    if (collision_event) {
-        if (collision_event->collider_1 == &bullet || collision_event->collider_2 == &bullet) {
-            if (collision_event->collider_1->GetName() == "bubble" ||
-                collision_event->collider_2->GetName() == "bubble") {
+    if (collision_event && collision_event->phase == ContactPhase::Enter) {
+        Entity *collider_1 = Engine::GetInstance().GetEntity(collision_event->collider_1);
+        Entity *collider_2 = Engine::GetInstance().GetEntity(collision_event->collider_2);
+        if (collider_1 == nullptr || collider_2 == nullptr) {
+            return;
+        }
+
+        if (collider_1 == &bullet || collider_2 == &bullet) {
+            if (collider_1->GetName() == "bubble" || collider_2->GetName() == "bubble") {
                 Log(LogLevel::Info,
                     "Collision between an bubble and a bullet detected in HandleBulletEvent");
-                Engine::GetInstance().RemoveEntity(collision_event->collider_1);
-                Engine::GetInstance().RemoveEntity(collision_event->collider_2);
+                Engine::GetInstance().RemoveEntity(collider_1);
+                Engine::GetInstance().RemoveEntity(collider_2);
             }
         }
     }
@@ -76,14 +96,19 @@ void HandleBulletEvent(Entity &bullet, Event &event) {
 void HandleBubbleEvent(Entity &bubble, Event &event) {
     CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
 
-    if (collision_event) {
-        if (collision_event->collider_1 == &bubble || collision_event->collider_2 == &bubble) {
-            if (collision_event->collider_1->GetName() == "bullet" ||
-                collision_event->collider_2->GetName() == "bullet") {
+    if (collision_event && collision_event->phase == ContactPhase::Enter) {
+        Entity *collider_1 = Engine::GetInstance().GetEntity(collision_event->collider_1);
+        Entity *collider_2 = Engine::GetInstance().GetEntity(collision_event->collider_2);
+        if (collider_1 == nullptr || collider_2 == nullptr) {
+            return;
+        }
+
+        if (collider_1 == &bubble || collider_2 == &bubble) {
+            if (collider_1->GetName() == "bullet" || collider_2->GetName() == "bullet") {
                 Log(LogLevel::Info,
                     "Collision between an bubble and a bullet detected in HandleBulletEvent");
-                Engine::GetInstance().RemoveEntity(collision_event->collider_1);
-                Engine::GetInstance().RemoveEntity(collision_event->collider_2);
+                Engine::GetInstance().RemoveEntity(collider_1);
+                Engine::GetInstance().RemoveEntity(collider_2);
             }
         }
     }
@@ -102,20 +127,30 @@ void AttachBubble(Entity *bubble) {
     Position grid_pos = GetNearestGridPosition(transform->GetPosition());
     transform->SetPosition(grid_pos);
     bubble->GetComponent<Physics>()->SetVelocity(Velocity{0, 0});
+    bubble->GetComponent<Collision>()->SetLayer(BUBBLE_LAYER);
 }
 
 // Check for collisions and attach new bubbles
 void HandleCollision(Entity *new_bubble) {
     Transform *new_bubble_transform = new_bubble->GetComponent<Transform>();
+    Position position = new_bubble_transform->GetPosition();
+    Size size = new_bubble_transform->GetSize();
+
+    // Only the bubbles next to the new one are looked up, with the box grown by a pixel so bubbles
+    // that just touch it count
+    static thread_local std::vector<Entity *> neighbours;
+    SDL_Rect box = {static_cast<int>(std::round(position.x)) - 1,
+                    static_cast<int>(std::round(position.y)) - 1, size.width + 2, size.height + 2};
+    Engine::GetInstance().QueryAABB(box, CollisionMaskOf(BUBBLE_LAYER), neighbours);
 
-    for (Entity *existing_bubble : bubbles) {
+    for (Entity *existing_bubble : neighbours) {
         if (existing_bubble == new_bubble)
             continue;
 
         Collision *collision = existing_bubble->GetComponent<Collision>();
         if (collision) {
             AttachBubble(new_bubble);
-            bubbles.push_back(new_bubble); // Add to global bubble container
+            bubbles.push_back(new_bubble->GetId()); // Add to global bubble container
             return;
         }
     }
@@ -224,7 +259,7 @@ void UpdateGun(Entity &gun) {
     }
 }
 
-void CreateBubbles(float x_coord, float y_coord, Color color, std::string texture) {
+Entity *CreateBubbles(float x_coord, float y_coord, Color color, std::string texture) {
     Entity *bubble = new Entity("bubble", EntityCategory::Stationary);
     bubble->AddComponent<Transform>();
     bubble->AddComponent<Render>();
@@ -233,13 +268,16 @@ void CreateBubbles(float x_coord, float y_coord, Color color, std::string textur
     bubble->AddComponent<Network>();
     bubble->AddComponent<Handler>();
 
+    bubble->GetComponent<Collision>()->SetLayer(BUBBLE_LAYER);
     bubble->GetComponent<Network>()->SetOwner(NetworkRole::Client);
     bubble->GetComponent<Render>()->SetTexture(texture);
     bubble->GetComponent<Transform>()->SetPosition({x_coord, y_coord});
     bubble->GetComponent<Transform>()->SetSize({70, 70}); // Bubble size
     bubble->GetComponent<Handler>()->SetUpdateCallback(UpdateBubble);
     bubble->GetComponent<Handler>()->SetEventCallback(HandleBubbleEvent);
-    bubbles.push_back(bubble); // Add to global bubble container
+    bubbles.push_back(bubble->GetId()); // Add to global bubble container
+
+    return bubble;
 }
 
 Entity *CreateGun() {
@@ -272,12 +310,10 @@ std::vector<Entity *> CreateEntities() {
             Color color = (row % 2 == 0) ? Color{255, 0, 0, 255}  // Red
                                          : Color{0, 0, 255, 255}; // Blue
             std::string texture = (row % 2 == 0) ? "red_bubble.png" : "blue_bubble.png";
-            CreateBubbles(x_coord, y_coord, color, texture);
+            entities.push_back(CreateBubbles(x_coord, y_coord, color, texture));
         }
     }
 
-    entities.insert(entities.end(), bubbles.begin(), bubbles.end());
-
     Entity *gun = CreateGun();
 
     entities.push_back(gun);
@@ -303,12 +339,6 @@ void AddObjectsToEngine(std::vector<Entity *> entities) {
     }
 }
 
-void DestroyEntities(std::vector<Entity *> entities) {
-    for (Entity *entity : entities) {
-        delete entity;
-    }
-}
-
 int main(int argc, char *args[]) {
     std::string game_title = "Mitesh's CSC581 HW5 Game: Bubble Shooter";
     int max_player_count = 100, texture_count = 4;
@@ -342,8 +372,5 @@ int main(int argc, char *args[]) {
     // The Start function keeps running until an "exit event occurs"
     Engine::GetInstance().Start();
     Log(LogLevel::Info, "The game engine has closed the game cleanly");
-
-    // Add Game Cleanup code (deallocating pointers)
-    DestroyEntities(entities);
     return 0;
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ Size window_size;
 int64_t last_bullet_fired_time = 0;
 bool alien_hit_right_boundary = false;
 bool alien_hit_left_boundary = false;
+int brick_tag = -1;
 
 struct PaddleEvent {
     bool move_left;
@@ -26,14 +27,7 @@ struct PaddleEvent {
 } paddle_event;
 
 void Update(std::vector<Entity *> &entities) {
-    std::vector<Entity *> bricks;
-    bool brick_found = false;
-    for (Entity *entity : entities) {
-        if (entity->GetName().substr(0, 5) == "brick") {
-            brick_found = true;
-            break;
-        }
-    }
+    bool brick_found = !Engine::GetInstance().QueryTag(brick_tag).empty();
 
     if (!brick_found) {
         Log(LogLevel::Info, "\n\nAll bricks are destroyed. You win!\n\n");
@@ -57,8 +51,9 @@ void HandleBrickEvent(Entity &brick, Event &event) {
 
     CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
 
-    if (collision_event) {
-        if (collision_event->collider_1 == &brick || collision_event->collider_2 == &brick) {
+    if (collision_event && collision_event->phase == ContactPhase::Enter) {
+        if (collision_event->collider_1 == brick.GetId() ||
+            collision_event->collider_2 == brick.GetId()) {
             Color brick_color = brick.GetComponent<Render>()->GetColor();
             if (brick_color.alpha == 255) {
                 brick.GetComponent<Render>()->SetColor(
@@ -73,10 +68,16 @@ void HandleBrickEvent(Entity &brick, Event &event) {
 void HandleBallEvent(Entity &ball, Event &event) {
     CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
 
-    if (collision_event) {
-        if (collision_event->collider_1 == &ball || collision_event->collider_2 == &ball) {
-            if (collision_event->collider_1->GetName() == "bottom_boundary" ||
-                collision_event->collider_2->GetName() == "bottom_boundary") {
+    if (collision_event && collision_event->phase == ContactPhase::Enter) {
+        Entity *collider_1 = Engine::GetInstance().GetEntity(collision_event->collider_1);
+        Entity *collider_2 = Engine::GetInstance().GetEntity(collision_event->collider_2);
+        if (collider_1 == nullptr || collider_2 == nullptr) {
+            return;
+        }
+
+        if (collider_1 == &ball || collider_2 == &ball) {
+            if (collider_1->GetName() == "bottom_boundary" ||
+                collider_2->GetName() == "bottom_boundary") {
                 Log(LogLevel::Info, "\n\nYou missed the ball :( ! You lose!\n\n");
                 app->quit.store(true);
             }
@@ -148,6 +149,7 @@ std::vector<Entity *> CreateBricks() {
         brick->AddComponent<Collision>();
         brick->AddComponent<Network>();
         brick->AddComponent<Handler>();
+        brick->AddTag(brick_tag);
 
         brick->GetComponent<Transform>()->SetPosition({float(190 + 160 * i), 150});
         brick->GetComponent<Transform>()->SetSize({150, 50});
@@ -165,6 +167,7 @@ std::vector<Entity *> CreateBricks() {
         brick->AddComponent<Collision>();
         brick->AddComponent<Network>();
         brick->AddComponent<Handler>();
+        brick->AddTag(brick_tag);
 
         brick->GetComponent<Transform>()->SetPosition({float(190 + 160 * (i - 10)), 80});
         brick->GetComponent<Transform>()->SetSize({150, 50});
@@ -299,12 +302,6 @@ void AddObjectsToEngine(std::vector<Entity *> entities) {
     }
 }
 
-void DestroyEntities(std::vector<Entity *> entities) {
-    for (Entity *entity : entities) {
-        delete entity;
-    }
-}
-
 int main(int argc, char *args[]) {
     std::string game_title = "Rohan's CSC581 HW5 Game: Brick Breaker";
     int max_player_count = 100, texture_count = 1;
@@ -336,6 +333,7 @@ int main(int argc, char *args[]) {
     }
 
     window_size = GetWindowSize();
+    brick_tag = Engine::GetInstance().RegisterTag("brick");
 
     std::vector<Entity *> entities = CreateEntities();
     AddObjectsToEngine(entities);
@@ -344,8 +342,5 @@ int main(int argc, char *args[]) {
     // The Start function keeps running until an "exit event occurs"
     Engine::GetInstance().Start();
     Log(LogLevel::Info, "The game engine has closed the game cleanly");
-
-    // Add Game Cleanup code (deallocating pointers)
-    DestroyEntities(entities);
     return 0;
 }
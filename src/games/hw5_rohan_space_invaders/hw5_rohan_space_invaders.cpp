@@ -20,6 +20,13 @@ int64_t last_bullet_fired_time = 0;
 bool alien_hit_right_boundary = false;
 bool alien_hit_left_boundary = false;
 int bullet_count = 0;
+int alien_tag = -1;
+int bullet_tag = -1;
+
+// Bullets are only tested against aliens and the top boundary
+const int BULLET_LAYER = 1;
+const int ALIEN_LAYER = 2;
+const int TOP_BOUNDARY_LAYER = 3;
 
 struct CannonEvent {
     bool move_left;
@@ -31,25 +38,23 @@ void Update(std::vector<Entity *> &entities) {
     bool alien_found = false;
     bool alien_win = false;
 
-    for (Entity *entity : entities) {
-        if (entity->GetName().substr(0, 5) == "alien") {
-            alien_found = true;
-            Velocity alien_velocity = entity->GetComponent<Physics>()->GetVelocity();
-            Position alien_position = entity->GetComponent<Transform>()->GetPosition();
-            if (alien_hit_left_boundary) {
-                entity->GetComponent<Physics>()->SetVelocity({5, 0});
-                entity->GetComponent<Transform>()->SetPosition(
-                    {alien_position.x, alien_position.y + 50});
-            }
-            if (alien_hit_right_boundary) {
-                entity->GetComponent<Physics>()->SetVelocity({-5, 0});
-                entity->GetComponent<Transform>()->SetPosition(
-                    {alien_position.x, alien_position.y + 50});
-            }
+    for (Entity *entity : Engine::GetInstance().QueryTag(alien_tag)) {
+        alien_found = true;
+        Velocity alien_velocity = entity->GetComponent<Physics>()->GetVelocity();
+        Position alien_position = entity->GetComponent<Transform>()->GetPosition();
+        if (alien_hit_left_boundary) {
+            entity->GetComponent<Physics>()->SetVelocity({5, 0});
+            entity->GetComponent<Transform>()->SetPosition(
+                {alien_position.x, alien_position.y + 50});
+        }
+        if (alien_hit_right_boundary) {
+            entity->GetComponent<Physics>()->SetVelocity({-5, 0});
+            entity->GetComponent<Transform>()->SetPosition(
+                {alien_position.x, alien_position.y + 50});
+        }
 
-            if (alien_position.y > 700) {
-                alien_win = true;
-            }
+        if (alien_position.y > 700) {
+            alien_win = true;
         }
     }
 
@@ -77,15 +82,20 @@ void UpdateAlien(Entity &alien) {}
 void HandleBulletEvent(Entity &bullet, Event &event) {
     CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
 
-    if (collision_event) {
-        if (collision_event->collider_1 == &bullet || collision_event->collider_2 == &bullet) {
-            if (collision_event->collider_1->GetName().substr(0, 5) == "alien" ||
-                collision_event->collider_2->GetName().substr(0, 5) == "alien") {
-                Engine::GetInstance().RemoveEntity(collision_event->collider_1);
-                Engine::GetInstance().RemoveEntity(collision_event->collider_2);
+    if (collision_event && collision_event->phase == ContactPhase::Enter) {
+        Entity *collider_1 = Engine::GetInstance().GetEntity(collision_event->collider_1);
+        Entity *collider_2 = Engine::GetInstance().GetEntity(collision_event->collider_2);
+        if (collider_1 == nullptr || collider_2 == nullptr) {
+            return;
+        }
+
+        if (collider_1 == &bullet || collider_2 == &bullet) {
+            if (collider_1->HasTag(alien_tag) || collider_2->HasTag(alien_tag)) {
+                Engine::GetInstance().RemoveEntity(collider_1);
+                Engine::GetInstance().RemoveEntity(collider_2);
             }
-            if (collision_event->collider_1->GetName() == "top_boundary" ||
-                collision_event->collider_2->GetName() == "top_boundary") {
+            if (collider_1->GetName() == "top_boundary" ||
+                collider_2->GetName() == "top_boundary") {
                 Engine::GetInstance().RemoveEntity(&bullet);
             }
         }
@@ -95,15 +105,20 @@ void HandleBulletEvent(Entity &bullet, Event &event) {
 void HandleAlienEvent(Entity &alien, Event &event) {
     CollisionEvent *collision_event = std::get_if<CollisionEvent>(&(event.data));
 
-    if (collision_event) {
-        if (collision_event->collider_1 == &alien || collision_event->collider_2 == &alien) {
-            std::string collider_1_name = collision_event->collider_1->GetName();
-            std::string collider_2_name = collision_event->collider_2->GetName();
+    if (collision_event && collision_event->phase == ContactPhase::Enter) {
+        Entity *collider_1 = Engine::GetInstance().GetEntity(collision_event->collider_1);
+        Entity *collider_2 = Engine::GetInstance().GetEntity(collision_event->collider_2);
+        if (collider_1 == nullptr || collider_2 == nullptr) {
+            return;
+        }
+
+        if (collider_1 == &alien || collider_2 == &alien) {
+            std::string collider_1_name = collider_1->GetName();
+            std::string collider_2_name = collider_2->GetName();
 
-            if (collider_1_name.substr(0, 6) == "bullet" ||
-                collider_2_name.substr(0, 6) == "bullet") {
-                Engine::GetInstance().RemoveEntity(collision_event->collider_1);
-                Engine::GetInstance().RemoveEntity(collision_event->collider_2);
+            if (collider_1->HasTag(bullet_tag) || collider_2->HasTag(bullet_tag)) {
+                Engine::GetInstance().RemoveEntity(collider_1);
+                Engine::GetInstance().RemoveEntity(collider_2);
             }
 
             if (collider_1_name == "left_boundary" || collider_2_name == "left_boundary") {
@@ -127,10 +142,15 @@ void Shoot(Position cannon_position) {
     bullet->AddComponent<Collision>();
     bullet->AddComponent<Network>();
     bullet->AddComponent<Handler>();
+    bullet->AddTag(bullet_tag);
 
     bullet->GetComponent<Transform>()->SetPosition(
         {cannon_position.x + 100, cannon_position.y - 20});
     bullet->GetComponent<Transform>()->SetSize({3, 10});
+    bullet->GetComponent<Collision>()->SetContinuous(true);
+    bullet->GetComponent<Collision>()->SetLayer(BULLET_LAYER);
+    bullet->GetComponent<Collision>()->SetMask(CollisionMaskOf(ALIEN_LAYER) |
+                                               CollisionMaskOf(TOP_BOUNDARY_LAYER));
     bullet->GetComponent<Render>()->SetColor({255, 255, 0, 255});
     bullet->GetComponent<Network>()->SetOwner(NetworkRole::Client);
     bullet->GetComponent<Handler>()->SetUpdateCallback(UpdateBullet);
@@ -230,9 +250,11 @@ std::vector<Entity *> CreateAliens() {
         alien->AddComponent<Collision>();
         alien->AddComponent<Network>();
         alien->AddComponent<Handler>();
+        alien->AddTag(alien_tag);
 
         alien->GetComponent<Transform>()->SetPosition({float(190 + 160 * i), 150});
         alien->GetComponent<Transform>()->SetSize({150, 100});
+        alien->GetComponent<Collision>()->SetLayer(ALIEN_LAYER);
         alien->GetComponent<Physics>()->SetVelocity({5, 0});
         alien->GetComponent<Render>()->SetTexture("alien_row_1.png");
         alien->GetComponent<Network>()->SetOwner(NetworkRole::Client);
@@ -249,10 +271,12 @@ std::vector<Entity *> CreateAliens() {
         alien->AddComponent<Collision>();
         alien->AddComponent<Network>();
         alien->AddComponent<Handler>();
+        alien->AddTag(alien_tag);
 
         alien->GetComponent<Transform>()->SetPosition({float(190 + 160 * (i - 10)), 40});
         alien->GetComponent<Physics>()->SetVelocity({5, 0});
         alien->GetComponent<Transform>()->SetSize({150, 100});
+        alien->GetComponent<Collision>()->SetLayer(ALIEN_LAYER);
         alien->GetComponent<Render>()->SetTexture("alien_row_2.png");
         alien->GetComponent<Network>()->SetOwner(NetworkRole::Client);
         alien->GetComponent<Handler>()->SetUpdateCallback(UpdateAlien);
@@ -277,6 +301,7 @@ std::vector<Entity *> CreateGameBoundaries() {
     right_boundary->AddComponent<Collision>();
     top_boundary->AddComponent<Transform>();
     top_boundary->AddComponent<Collision>();
+    top_boundary->GetComponent<Collision>()->SetLayer(TOP_BOUNDARY_LAYER);
     bottom_boundary->AddComponent<Transform>();
     bottom_boundary->AddComponent<Collision>();
 
@@ -347,12 +372,6 @@ void AddObjectsToEngine(std::vector<Entity *> entities) {
     }
 }
 
-void DestroyEntities(std::vector<Entity *> entities) {
-    for (Entity *entity : entities) {
-        delete entity;
-    }
-}
-
 int main(int argc, char *args[]) {
     std::string game_title = "Rohan's CSC581 HW5 Game: Space Invaders";
     int max_player_count = 100, texture_count = 1;
@@ -375,6 +394,7 @@ int main(int argc, char *args[]) {
     Engine::GetInstance().SetPlayerTextures(texture_count);
     Engine::GetInstance().SetMaxPlayers(max_player_count);
     Engine::GetInstance().SetShowPlayerBorder(false);
+    Engine::GetInstance().SetLayersCollide(ALIEN_LAYER, ALIEN_LAYER, false);
 
     network_info = Engine::GetInstance().GetNetworkInfo();
     if (network_info.id > max_player_count) {
@@ -384,6 +404,8 @@ int main(int argc, char *args[]) {
     }
 
     window_size = GetWindowSize();
+    alien_tag = Engine::GetInstance().RegisterTag("alien");
+    bullet_tag = Engine::GetInstance().RegisterTag("bullet");
 
     std::vector<Entity *> entities = CreateEntities();
     AddObjectsToEngine(entities);
@@ -392,8 +414,5 @@ int main(int argc, char *args[]) {
     // The Start function keeps running until an "exit event occurs"
     Engine::GetInstance().Start();
     Log(LogLevel::Info, "The game engine has closed the game cleanly");
-
-    // Add Game Cleanup code (deallocating pointers)
-    DestroyEntities(entities);
     return 0;
 }